@@ -0,0 +1,361 @@
+
+#ifndef MYSTL_COMPACT_LIST_H
+#define MYSTL_COMPACT_LIST_H
+
+//用32位下标链接的双向链表，全部节点放在一块连续的数组(arena)中
+//list_node的两个指针在64位下占16字节，节点分散在内存池的各个chunk中；compact_list的两个下标只占8字节，遍历也集中在一块内存中
+//下标0是哨兵节点，删除的节点通过next串成空闲链，插入时优先复用
+//数组满时像vector一样扩大一倍并搬移元素，下标不变，所以迭代器(保存下标)在扩容后仍然有效，只有指向元素的指针和引用会失效
+//T可以平凡拷贝时，搬移和拷贝整个链表只需要一次memcpy
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <initializer_list>
+#include <type_traits>
+#include "iterator.h"
+#include "pool_allocator.h"
+#include "construct.h"
+#include "move.h"
+
+namespace MyStl{
+    template <typename List, typename Ref, typename Ptr>
+    struct compact_list_iterator;
+
+    template <typename T>
+    class compact_list{
+    public:
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using index_type = uint32_t;
+        using iterator = compact_list_iterator<compact_list, T&, T*>;
+        using const_iterator = compact_list_iterator<const compact_list, const T&, const T*>;
+        using reverse_iter = reverse_iterator<iterator>;
+        using const_reverse_iter = reverse_iterator<const_iterator>;
+
+        template <typename List, typename Ref, typename Ptr>
+        friend struct compact_list_iterator;
+
+    protected:
+        struct node{
+            index_type next;
+            index_type prev;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+            T* ptr() { return reinterpret_cast<T*>(&storage); }
+        };
+        using node_alloc = pool_alloc<node>;
+        //空闲节点的prev标记为free_mark，空闲链以哨兵下标0结尾
+        enum : index_type { sentinel = 0, free_mark = 0xFFFFFFFFu };
+        enum { init_capacity = 8 };
+
+        node* nodes;
+        //数组能放下的节点数，下标[0, used)的节点使用过，其中不在链表中的都在空闲链上
+        index_type cap;
+        index_type used;
+        index_type free_head;
+        size_type len;
+
+        static size_type max_nodes() { return size_type(free_mark); }
+        void empty_initialize() {
+            nodes = node_alloc::allocate(init_capacity);
+            cap = init_capacity;
+            used = 1;
+            free_head = sentinel;
+            len = 0;
+            nodes[sentinel].next = sentinel;
+            nodes[sentinel].prev = sentinel;
+        }
+        bool is_free(index_type i) const { return nodes[i].prev == free_mark; }
+        //把节点搬到容量为new_cap的新数组中
+        void reallocate(index_type new_cap);
+        void relocate(node* new_nodes, std::true_type) {
+            std::memcpy(static_cast<void*>(new_nodes), nodes, sizeof(node) * used);
+        }
+        void relocate(node* new_nodes, std::false_type);
+        index_type grow_size() const {
+            if (size_type(cap) == max_nodes())
+                throw std::length_error("compact_list: too many nodes");
+            const size_type n = 2 * size_type(cap);
+            return index_type(n < max_nodes() ? n : max_nodes());
+        }
+        //取一个未使用的节点，调用前必须有空闲节点或者used < cap
+        index_type acquire_node() {
+            if (free_head != sentinel) {
+                const index_type i = free_head;
+                free_head = nodes[i].next;
+                return i;
+            }
+            return used++;
+        }
+        //析构后的节点放回空闲链
+        void release_node(index_type i) {
+            nodes[i].next = free_head;
+            nodes[i].prev = free_mark;
+            free_head = i;
+        }
+        //在下标pos的节点之前链接节点i
+        void link_before(index_type pos, index_type i) {
+            nodes[i].next = pos;
+            nodes[i].prev = nodes[pos].prev;
+            nodes[nodes[pos].prev].next = i;
+            nodes[pos].prev = i;
+        }
+        void copy_from(const compact_list& rhs, std::true_type);
+        void copy_from(const compact_list& rhs, std::false_type);
+        void destroy_all() {
+            for (index_type i = nodes[sentinel].next; i != sentinel; i = nodes[i].next)
+                MyStl::destroy(nodes[i].ptr());
+        }
+
+    public:
+        /*构造与析构*/
+        compact_list() { empty_initialize(); }
+        compact_list(size_type n, const value_type& value) { fill_initialize(n, value); }
+        compact_list(int n, const value_type& value) { fill_initialize(size_type(n), value); }
+        compact_list(long n, const value_type& value) { fill_initialize(size_type(n), value); }
+        template <typename InputIterator>
+        compact_list(InputIterator first, InputIterator last) {
+            empty_initialize();
+            try {
+                for (; first != last; ++first)
+                    push_back(*first);
+            } catch (...) {
+                destroy_all();
+                node_alloc::deallocate(nodes, cap);
+                throw;
+            }
+        }
+        compact_list(std::initializer_list<T> il) : compact_list(il.begin(), il.end()) {}
+        compact_list(const compact_list& rhs) {
+            copy_from(rhs, std::integral_constant<bool, std::is_trivially_copyable<T>::value>());
+        }
+        compact_list& operator=(const compact_list& rhs) {
+            if (&rhs != this) {
+                compact_list temp(rhs);
+                swap(temp);
+            }
+            return *this;
+        }
+        ~compact_list() {
+            destroy_all();
+            node_alloc::deallocate(nodes, cap);
+        }
+
+        //元素访问
+        reference front() { return *nodes[nodes[sentinel].next].ptr(); }
+        const_reference front() const { return *nodes[nodes[sentinel].next].ptr(); }
+        reference back() { return *nodes[nodes[sentinel].prev].ptr(); }
+        const_reference back() const { return *nodes[nodes[sentinel].prev].ptr(); }
+
+        //迭代器
+        iterator begin() { return iterator(this, nodes[sentinel].next); }
+        iterator end() { return iterator(this, sentinel); }
+        const_iterator begin() const { return const_iterator(this, nodes[sentinel].next); }
+        const_iterator end() const { return const_iterator(this, sentinel); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+        reverse_iter rbegin() { return reverse_iter(end()); }
+        reverse_iter rend() { return reverse_iter(begin()); }
+
+        //容量
+        size_type size() const { return len; }
+        bool empty() const { return len == 0; }
+        //不扩容时最多能放下的元素个数，哨兵占一个节点
+        size_type capacity() const { return size_type(cap) - 1; }
+        void reserve(size_type n) {
+            if (n >= max_nodes())
+                throw std::length_error("compact_list: too many nodes");
+            if (n + 1 > cap)
+                reallocate(index_type(n + 1));
+        }
+        //每个节点占用的字节数
+        static constexpr size_type node_bytes() { return sizeof(node); }
+
+        //修改器
+        iterator insert(iterator pos, const value_type& value);
+        iterator erase(iterator pos) {
+            const index_type i = pos.index;
+            const index_type next = nodes[i].next;
+            nodes[nodes[i].prev].next = next;
+            nodes[next].prev = nodes[i].prev;
+            MyStl::destroy(nodes[i].ptr());
+            release_node(i);
+            --len;
+            return iterator(this, next);
+        }
+        iterator erase(iterator first, iterator last) {
+            while (first != last)
+                first = erase(first);
+            return last;
+        }
+        void push_back(const value_type& value) { insert(end(), value); }
+        void push_front(const value_type& value) { insert(begin(), value); }
+        void pop_back() { erase(iterator(this, nodes[sentinel].prev)); }
+        void pop_front() { erase(begin()); }
+        //析构全部元素，保留数组
+        void clear() {
+            destroy_all();
+            used = 1;
+            free_head = sentinel;
+            len = 0;
+            nodes[sentinel].next = sentinel;
+            nodes[sentinel].prev = sentinel;
+        }
+        void swap(compact_list& rhs) {
+            std::swap(nodes, rhs.nodes);
+            std::swap(cap, rhs.cap);
+            std::swap(used, rhs.used);
+            std::swap(free_head, rhs.free_head);
+            std::swap(len, rhs.len);
+        }
+
+    protected:
+        void fill_initialize(size_type n, const value_type& value) {
+            empty_initialize();
+            try {
+                reserve(n);
+                for (; n; --n)
+                    push_back(value);
+            } catch (...) {
+                destroy_all();
+                node_alloc::deallocate(nodes, cap);
+                throw;
+            }
+        }
+    };
+
+    template <typename T>
+    void compact_list<T>::relocate(node* new_nodes, std::false_type) {
+        index_type i = 0;
+        try {
+            for (; i < used; ++i) {
+                new_nodes[i].next = nodes[i].next;
+                new_nodes[i].prev = nodes[i].prev;
+                if (i != sentinel && !is_free(i))
+                    MyStl::construct(new_nodes[i].ptr(), MyStl::move(*nodes[i].ptr()));
+            }
+        } catch (...) {
+            for (index_type j = 1; j < i; ++j)
+                if (!is_free(j))
+                    MyStl::destroy(new_nodes[j].ptr());
+            throw;
+        }
+        for (i = 1; i < used; ++i)
+            if (!is_free(i))
+                MyStl::destroy(nodes[i].ptr());
+    }
+
+    template <typename T>
+    void compact_list<T>::reallocate(index_type new_cap) {
+        node* new_nodes = node_alloc::allocate(new_cap);
+        try {
+            relocate(new_nodes, std::integral_constant<bool, std::is_trivially_copyable<T>::value>());
+        } catch (...) {
+            node_alloc::deallocate(new_nodes, new_cap);
+            throw;
+        }
+        node_alloc::deallocate(nodes, cap);
+        nodes = new_nodes;
+        cap = new_cap;
+    }
+
+    template <typename T>
+    void compact_list<T>::copy_from(const compact_list& rhs, std::true_type) {
+        //连同空闲链一起整块拷贝，下标保持不变
+        nodes = node_alloc::allocate(rhs.cap);
+        std::memcpy(static_cast<void*>(nodes), rhs.nodes, sizeof(node) * rhs.used);
+        cap = rhs.cap;
+        used = rhs.used;
+        free_head = rhs.free_head;
+        len = rhs.len;
+    }
+
+    template <typename T>
+    void compact_list<T>::copy_from(const compact_list& rhs, std::false_type) {
+        //逐个拷贝，新链表中的节点按顺序排列，没有空闲节点
+        empty_initialize();
+        try {
+            reserve(rhs.len);
+            for (const_iterator it = rhs.begin(); it != rhs.end(); ++it)
+                push_back(*it);
+        } catch (...) {
+            destroy_all();
+            node_alloc::deallocate(nodes, cap);
+            throw;
+        }
+    }
+
+    template <typename T>
+    typename compact_list<T>::iterator compact_list<T>::insert(iterator pos, const value_type& value) {
+        if (free_head == sentinel && used == cap) {
+            //扩容会搬移元素，value可能就是链表中的元素，先拷贝一份
+            value_type temp(value);
+            reallocate(grow_size());
+            return insert(pos, temp);
+        }
+        const index_type i = acquire_node();
+        try {
+            MyStl::construct(nodes[i].ptr(), value);
+        } catch (...) {
+            release_node(i);
+            throw;
+        }
+        link_before(pos.index, i);
+        ++len;
+        return iterator(this, i);
+    }
+
+    template <typename T>
+    bool operator==(const compact_list<T>& lhs, const compact_list<T>& rhs) {
+        if (lhs.size() != rhs.size())
+            return false;
+        auto it1 = lhs.begin();
+        for (auto it2 = rhs.begin(); it2 != rhs.end(); ++it1, ++it2)
+            if (!(*it1 == *it2))
+                return false;
+        return true;
+    }
+
+    template <typename T>
+    bool operator!=(const compact_list<T>& lhs, const compact_list<T>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    //和ring_deque_iterator一样保存容器指针和下标，扩容后仍然有效
+    template <typename List, typename Ref, typename Ptr>
+    struct compact_list_iterator{
+        using iterator_category = bidirectional_iterator_tag;
+        using value_type        = typename remove_const_t<List>::value_type;
+        using difference_type   = ptrdiff_t;
+        using reference         = Ref;
+        using pointer           = Ptr;
+        using index_type        = uint32_t;
+        using self              = compact_list_iterator;
+
+        List* lst;
+        index_type index;
+
+        compact_list_iterator() : lst(nullptr), index(0) {}
+        compact_list_iterator(List* l, index_type i) : lst(l), index(i) {}
+        //iterator可以转换为const_iterator
+        template <typename L, typename R, typename P>
+        compact_list_iterator(const compact_list_iterator<L, R, P>& it) : lst(it.lst), index(it.index) {}
+
+        reference operator*() const { return *lst->nodes[index].ptr(); }
+        pointer operator->() const { return lst->nodes[index].ptr(); }
+
+        self& operator++() { index = lst->nodes[index].next; return *this; }
+        self operator++(int) { self tmp = *this; ++*this; return tmp; }
+        self& operator--() { index = lst->nodes[index].prev; return *this; }
+        self operator--(int) { self tmp = *this; --*this; return tmp; }
+
+        bool operator==(const self& rhs) const { return index == rhs.index; }
+        bool operator!=(const self& rhs) const { return index != rhs.index; }
+    };
+}
+
+#endif //MYSTL_COMPACT_LIST_H
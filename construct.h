@@ -8,8 +8,8 @@ namespace MyStl{
 
     template<typename Up, typename... Args>
     inline
-    void construct(Up* p, Args&&... args) noexcept{
-        ::new((void*)p) Up(forward<Args>(args)...);
+    void construct(Up* p, Args&&... args) {
+        ::new((void*)p) Up(MyStl::forward<Args>(args)...);
     }
 
     template<typename T1, typename T2>
@@ -34,7 +34,7 @@ namespace MyStl{
                             ForwardIterator last,
                             _false_type) {
         for (; first != last; ++first)
-            destroy(first);
+            destroy(&*first);
     }
 
     // 两个参数的全局 destroy 函数，根据其是否具有 trivial 析构函数进行重载
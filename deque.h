@@ -5,18 +5,49 @@
 #include "pool_allocator.h"
 #include "construct.h"
 #include "uninitialized.h"
+#include "parallel_uninitialized.h"
+#include "snapshot.h"
+#include "prefetch.h"
+#include <type_traits>
+#include <algorithm>
+#include <numeric>
+#include <new>
+#include <cstdlib>
 #include "initializer_list"
 #include "iostream"
 namespace MyStl{
     //缓存区辅助函数，buf_size是用户设计的size，如果用户没设置，则使用默认的内存空间大小(512字节)
     //这里的size_t指代的是元素的个数，val_size是单个元素所占的内存空间
-    inline size_t deque_buf_size(size_t buf_size, size_t val_size) {
+    constexpr size_t deque_buf_size(size_t buf_size, size_t val_size) {
         return (buf_size != 0) ? buf_size
                                : ( (val_size < 512) ? size_t(512 / val_size) : size_t(1) );
     }
 
+    //n为2的幂时返回log2(n)
+    constexpr size_t deque_log2(size_t n) { return n <= 1 ? 0 : 1 + deque_log2(n >> 1); }
+
+    //缓冲区的对齐方式：不小于一页的缓冲区按页对齐，其余按缓存行对齐，避免缓冲区首尾与其它数据共享缓存行
+    enum { deque_cache_line = 64, deque_page_size = 4096 };
+    inline size_t deque_block_align(size_t bytes, size_t val_align) {
+        size_t align = bytes >= deque_page_size ? size_t(deque_page_size) : size_t(deque_cache_line);
+        return align < val_align ? val_align : align;
+    }
+
+    //缓冲区分配器，缓冲区大小不在内存池的范围内，直接使用posix_memalign按对齐分配
+    template <typename T>
+    struct deque_block_alloc {
+        static T* allocate(size_t n) {
+            void* ptr = nullptr;
+            if (posix_memalign(&ptr, deque_block_align(n * sizeof(T), alignof(T)), n * sizeof(T)) != 0)
+                throw std::bad_alloc();
+            return static_cast<T*>(ptr);
+        }
+        static void deallocate(T* ptr) { free(ptr); }
+    };
+
     //和list一样，deque也需要自己设置迭代器，因为
-    template <typename T, typename Ref, typename Ptr>
+    //BufSiz为每个缓冲区的元素个数，为0时使用默认的512字节
+    template <typename T, typename Ref, typename Ptr, size_t BufSiz = 0>
     struct deque_iterator {
 
         using iterator_category = random_access_iterator_tag;
@@ -27,8 +58,8 @@ namespace MyStl{
         using difference_type = ptrdiff_t;
         using map_pointer = T**;
 
-        using iterator = deque_iterator<T, T&, T*>;
-        using const_iterator = deque_iterator<T, const T&, const T*>;
+        using iterator = deque_iterator<T, T&, T*, BufSiz>;
+        using const_iterator = deque_iterator<T, const T&, const T*, BufSiz>;
         using self = deque_iterator;
 
         //内部指针
@@ -40,8 +71,23 @@ namespace MyStl{
         T* last;
         map_pointer node;  //指向中控器中当前迭代器所指节点
 
-        //返回默认分配内存能够容纳的元素个数
-        static size_t buffer_size() { return deque_buf_size(0, sizeof(T)); }
+        //返回每个缓冲区能够容纳的元素个数
+        static constexpr size_t buffer_size() { return deque_buf_size(BufSiz, sizeof(T)); }
+        //缓冲区大小为2的幂时，定位元素只需要移位和取掩码，不需要除法和乘法
+        static constexpr bool buffer_pow2() { return (buffer_size() & (buffer_size() - 1)) == 0; }
+        static constexpr size_t buffer_shift() { return deque_log2(buffer_size()); }
+        //offset是相对于某个缓冲区首元素的偏移，返回元素所在节点相对于该节点的偏移(向下取整)
+        static difference_type node_offset(difference_type offset) {
+            //有符号数的右移是算术右移，负数同样向下取整
+            return buffer_pow2() ? (offset >> buffer_shift())
+                                 : offset >= 0 ? offset / difference_type(buffer_size())
+                                               : -difference_type((-offset - 1) / buffer_size()) - 1;
+        }
+        //返回元素在所在缓冲区中的下标
+        static difference_type elem_offset(difference_type offset, difference_type node_off) {
+            return buffer_pow2() ? (offset & difference_type(buffer_size() - 1))
+                                 : offset - node_off * difference_type(buffer_size());
+        }
         //set_node实现中控器节点的跳转，跳转之后node指向新的节点，其余三个指针也指向新的缓冲区
         void set_node(map_pointer new_node) {
             node = new_node;
@@ -61,8 +107,9 @@ namespace MyStl{
         //操作符重载
         //随机访问迭代器类型需要提供两个迭代器相减的重载操作
         difference_type operator-(const self& iter) const {
-            return difference_type(buffer_size()) * (node - iter.node - 1) +
-                   (cur - first) + (iter.last - iter.cur);
+            //nodes可能为-1，负数左移是未定义行为，直接用乘法，缓冲区大小为2的幂时编译器同样会生成移位
+            const difference_type nodes = node - iter.node - 1;
+            return difference_type(buffer_size()) * nodes + (cur - first) + (iter.last - iter.cur);
         }
 
         deque_iterator& operator=(const deque_iterator&) = default;
@@ -105,10 +152,9 @@ namespace MyStl{
             if (offset >= 0 && offset < difference_type(buffer_size())){
                 cur += n;
             } else {
-                const difference_type node_offset = offset > 0 ? difference_type(offset / buffer_size())
-                        : -difference_type((-offset - 1) / buffer_size()) - 1;
-                set_node(node + node_offset);
-                cur = first + (offset - node_offset * difference_type(buffer_size()));
+                const difference_type node_off = node_offset(offset);
+                set_node(node + node_off);
+                cur = first + elem_offset(offset, node_off);
             }
             return *this;
         }
@@ -126,7 +172,12 @@ namespace MyStl{
             return tmp -= n;
         }
 
-        reference operator[](difference_type n) const { return *(*this + n);}
+        //直接通过map定位元素，不需要构造临时迭代器
+        reference operator[](difference_type n) const {
+            const difference_type offset = n + (cur - first);
+            const difference_type node_off = node_offset(offset);
+            return node[node_off][elem_offset(offset, node_off)];
+        }
 
         //关系操作符
         bool operator==(const self& iter) const { return cur == iter.cur; }
@@ -136,7 +187,183 @@ namespace MyStl{
         }
     };
 
-    template<typename T>
+    /*deque迭代器的分段算法
+     * deque的元素只在每个缓冲区内连续，逐个元素++需要每步判断是否到达缓冲区末尾
+     * 这里按缓冲区分段处理，每一段都是一对指针，交给指针版本的算法
+     * 指针版本的std::copy/std::fill对平凡类型会使用memmove/memset，其余的循环编译器也可以向量化
+     */
+    template <typename T, typename Ref, typename Ptr, size_t BufSiz, typename OutputIterator>
+    OutputIterator copy(deque_iterator<T, Ref, Ptr, BufSiz> first,
+                        deque_iterator<T, Ref, Ptr, BufSiz> last, OutputIterator result) {
+        if (first.node == last.node)
+            return std::copy(first.cur, last.cur, result);
+        result = std::copy(first.cur, first.last, result);
+        for (T** node = first.node + 1; node != last.node; ++node)
+            result = std::copy(*node, *node + first.buffer_size(), result);
+        return std::copy(last.first, last.cur, result);
+    }
+
+    //源和目标都是deque时，每一段取两边缓冲区剩余长度的较小值
+    template <typename T, typename Ref, typename Ptr, size_t BufSiz>
+    deque_iterator<T, T&, T*, BufSiz> copy(deque_iterator<T, Ref, Ptr, BufSiz> first,
+                                           deque_iterator<T, Ref, Ptr, BufSiz> last,
+                                           deque_iterator<T, T&, T*, BufSiz> result) {
+        ptrdiff_t n = last - first;
+        while (n > 0) {
+            ptrdiff_t len = std::min(n, std::min(ptrdiff_t(first.last - first.cur),
+                                                 ptrdiff_t(result.last - result.cur)));
+            std::copy(first.cur, first.cur + len, result.cur);
+            first += len;
+            result += len;
+            n -= len;
+        }
+        return result;
+    }
+
+    //从后向前复制，cur在缓冲区首部时这一段属于前一个缓冲区
+    template <typename T, typename Ref, typename Ptr, size_t BufSiz>
+    deque_iterator<T, T&, T*, BufSiz> copy_backward(deque_iterator<T, Ref, Ptr, BufSiz> first,
+                                                    deque_iterator<T, Ref, Ptr, BufSiz> last,
+                                                    deque_iterator<T, T&, T*, BufSiz> result) {
+        const ptrdiff_t buf = ptrdiff_t(first.buffer_size());
+        ptrdiff_t n = last - first;
+        while (n > 0) {
+            ptrdiff_t src_len = last.cur - last.first;
+            T* src_end = last.cur;
+            if (src_len == 0) {
+                src_len = buf;
+                src_end = *(last.node - 1) + buf;
+            }
+            ptrdiff_t dst_len = result.cur - result.first;
+            T* dst_end = result.cur;
+            if (dst_len == 0) {
+                dst_len = buf;
+                dst_end = *(result.node - 1) + buf;
+            }
+            ptrdiff_t len = std::min(n, std::min(src_len, dst_len));
+            std::copy_backward(src_end - len, src_end, dst_end);
+            last -= len;
+            result -= len;
+            n -= len;
+        }
+        return result;
+    }
+
+    //和上面的copy/copy_backward分段方式相同，每一段使用指针版本的std::move/std::move_backward
+    template <typename T, size_t BufSiz>
+    deque_iterator<T, T&, T*, BufSiz> move(deque_iterator<T, T&, T*, BufSiz> first,
+                                           deque_iterator<T, T&, T*, BufSiz> last,
+                                           deque_iterator<T, T&, T*, BufSiz> result) {
+        ptrdiff_t n = last - first;
+        while (n > 0) {
+            ptrdiff_t len = std::min(n, std::min(ptrdiff_t(first.last - first.cur),
+                                                 ptrdiff_t(result.last - result.cur)));
+            std::move(first.cur, first.cur + len, result.cur);
+            first += len;
+            result += len;
+            n -= len;
+        }
+        return result;
+    }
+
+    template <typename T, size_t BufSiz>
+    deque_iterator<T, T&, T*, BufSiz> move_backward(deque_iterator<T, T&, T*, BufSiz> first,
+                                                    deque_iterator<T, T&, T*, BufSiz> last,
+                                                    deque_iterator<T, T&, T*, BufSiz> result) {
+        const ptrdiff_t buf = ptrdiff_t(first.buffer_size());
+        ptrdiff_t n = last - first;
+        while (n > 0) {
+            ptrdiff_t src_len = last.cur - last.first;
+            T* src_end = last.cur;
+            if (src_len == 0) {
+                src_len = buf;
+                src_end = *(last.node - 1) + buf;
+            }
+            ptrdiff_t dst_len = result.cur - result.first;
+            T* dst_end = result.cur;
+            if (dst_len == 0) {
+                dst_len = buf;
+                dst_end = *(result.node - 1) + buf;
+            }
+            ptrdiff_t len = std::min(n, std::min(src_len, dst_len));
+            std::move_backward(src_end - len, src_end, dst_end);
+            last -= len;
+            result -= len;
+            n -= len;
+        }
+        return result;
+    }
+
+    template <typename T, size_t BufSiz>
+    void fill(deque_iterator<T, T&, T*, BufSiz> first, deque_iterator<T, T&, T*, BufSiz> last,
+              const T& value) {
+        if (first.node == last.node) {
+            std::fill(first.cur, last.cur, value);
+            return;
+        }
+        std::fill(first.cur, first.last, value);
+        for (T** node = first.node + 1; node != last.node; ++node)
+            std::fill(*node, *node + first.buffer_size(), value);
+        std::fill(last.first, last.cur, value);
+    }
+
+    template <typename T, typename Ref, typename Ptr, size_t BufSiz, typename Function>
+    Function for_each(deque_iterator<T, Ref, Ptr, BufSiz> first,
+                      deque_iterator<T, Ref, Ptr, BufSiz> last, Function f) {
+        //函数对象(例如lambda)不一定可以赋值，所以直接在每一段上循环调用
+        while (first.node != last.node) {
+            //下一个缓冲区和当前缓冲区不一定相邻，硬件预取跟不上，处理这一段之前先预取下一段的开头
+            MyStl::prefetch(*(first.node + 1));
+            for (T* cur = first.cur; cur != first.last; ++cur)
+                f(*cur);
+            first.set_node(first.node + 1);
+            first.cur = first.first;
+        }
+        for (T* cur = first.cur; cur != last.cur; ++cur)
+            f(*cur);
+        return f;
+    }
+
+    template <typename T, typename Ref, typename Ptr, size_t BufSiz>
+    deque_iterator<T, Ref, Ptr, BufSiz> find(deque_iterator<T, Ref, Ptr, BufSiz> first,
+                                             deque_iterator<T, Ref, Ptr, BufSiz> last, const T& value) {
+        while (first.node != last.node) {
+            MyStl::prefetch(*(first.node + 1));
+            T* pos = std::find(first.cur, first.last, value);
+            if (pos != first.last) {
+                first.cur = pos;
+                return first;
+            }
+            first.set_node(first.node + 1);
+            first.cur = first.first;
+        }
+        first.cur = std::find(first.cur, last.cur, value);
+        return first;
+    }
+
+    template <typename T, typename Ref, typename Ptr, size_t BufSiz, typename U, typename BinaryOperation>
+    U accumulate(deque_iterator<T, Ref, Ptr, BufSiz> first,
+                 deque_iterator<T, Ref, Ptr, BufSiz> last, U init, BinaryOperation op) {
+        if (first.node == last.node)
+            return std::accumulate(first.cur, last.cur, init, op);
+        init = std::accumulate(first.cur, first.last, init, op);
+        for (T** node = first.node + 1; node != last.node; ++node)
+            init = std::accumulate(*node, *node + first.buffer_size(), init, op);
+        return std::accumulate(last.first, last.cur, init, op);
+    }
+
+    template <typename T, typename Ref, typename Ptr, size_t BufSiz, typename U>
+    U accumulate(deque_iterator<T, Ref, Ptr, BufSiz> first, deque_iterator<T, Ref, Ptr, BufSiz> last, U init) {
+        if (first.node == last.node)
+            return std::accumulate(first.cur, last.cur, init);
+        init = std::accumulate(first.cur, first.last, init);
+        for (T** node = first.node + 1; node != last.node; ++node)
+            init = std::accumulate(*node, *node + first.buffer_size(), init);
+        return std::accumulate(last.first, last.cur, init);
+    }
+
+    //BufSiz在编译期指定缓冲区的元素个数：大缓冲区减少map的节点数，小缓冲区减少首尾缓冲区的浪费
+    template<typename T, size_t BufSiz = 0>
     class deque{
     public:
         using value_type = T;
@@ -146,8 +373,8 @@ namespace MyStl{
         using const_reference = const T&;
         using size_type = size_t;
         using difference_type = ptrdiff_t;
-        using iterator = deque_iterator<T, T&, T*>;
-        using const_iterator = deque_iterator<T, const T&, const T*>;
+        using iterator = deque_iterator<T, T&, T*, BufSiz>;
+        using const_iterator = deque_iterator<T, const T&, const T*, BufSiz>;
         using reverse_iter = reverse_iterator<iterator>;
         using const_reverse_iter = reverse_iterator<const_iterator>;
 
@@ -156,6 +383,7 @@ namespace MyStl{
         //deque不同的地方在于需要分配两块内存，一块是中控器map，一块是缓冲区
         using data_alloc = pool_alloc<value_type>;
         using map_alloc = pool_alloc<pointer>;
+        using block_alloc = deque_block_alloc<value_type>;
 
         //deque内部成员
         //vector中end_of_storage相对于deque中的map_size，记录最大容积
@@ -163,10 +391,15 @@ namespace MyStl{
         size_type map_size = 0;
         iterator start;
         iterator finish;
+        //备用缓冲区：释放的缓冲区先留在这里，下次申请时直接取出
+        //深度稳定的队列每次跨越缓冲区边界时，pop_front释放的缓冲区正好给push_back使用，不需要再调用分配器
+        enum { max_spare_nodes = 2 };
+        pointer spare_nodes[max_spare_nodes];
+        size_type spare_count = 0;
 
     protected:
         //辅助函数
-        static size_type buffer_size() { return deque_buf_size(0, sizeof(T)); }
+        static constexpr size_type buffer_size() { return deque_buf_size(BufSiz, sizeof(T)); }
         static size_type init_map_size() { return 8; }
 
         /*内存操作
@@ -174,14 +407,38 @@ namespace MyStl{
          * 其实allocate_node也可以省略
          */
         //申请缓冲区内存
-        pointer allocate_node() { return data_alloc::allocate(buffer_size());}
-        void deallocate_node(pointer ptr) { data_alloc::deallocate(ptr); }
+        pointer allocate_node() {
+            return spare_count ? spare_nodes[--spare_count] : block_alloc::allocate(buffer_size());
+        }
+        void deallocate_node(pointer ptr) {
+            if (spare_count < max_spare_nodes)
+                spare_nodes[spare_count++] = ptr;
+            else
+                block_alloc::deallocate(ptr);
+        }
+        //把备用缓冲区还给分配器
+        void release_spare_nodes() {
+            while (spare_count)
+                block_alloc::deallocate(spare_nodes[--spare_count]);
+        }
         //负责产生和回收map结构，不设初值
         void create_map_nodes(size_type num_element);
         //destroy_map_nodes相对于分别调用调用data_alloc和map_alloc的deallocate函数，释放内存
         void destroy_map_nodes();
         //产生新的map，复制旧map，然后摧毁;相对于扩容操作，所以很有用
         void reallocate_map(size_type nodes_to_add, bool add_at_front);
+        //把map缩小为new_map_size，存活节点放在中间；缩小只是为了节省内存，分配失败时保留原map
+        void shrink_map(size_type new_map_size);
+        //自动压缩策略：存活节点不到map的1/8时把map缩小到存活节点的4倍
+        //只在clear和reallocate_map中执行，这两处本来就会使迭代器失效，pop_front/pop_back不移动map，其他迭代器保持有效
+        //缩小后的map超过所需的两倍，reallocate_map只会重新居中，稳定的队列不会反复扩容和缩小
+        enum { compact_min_map_size = 64 };
+        static bool map_too_sparse(size_type map_size, size_type nodes) {
+            return map_size >= compact_min_map_size && nodes * 8 < map_size;
+        }
+        static size_type compact_map_size(size_type nodes) {
+            return std::max(init_map_size(), nodes * 4 + 2);
+        }
 
 
         /*初始化操作*/
@@ -215,6 +472,10 @@ namespace MyStl{
                 reallocate_map(nodes_to_add, true);
         }
 
+        //只分配能容纳n个元素的缓冲区，不构造元素，供load使用；create_map_nodes失败时自己释放已分配的内存
+        struct storage_only_tag{};
+        deque(size_type n, storage_only_tag) { create_map_nodes(n); }
+
     public:
         /*构造与析构*/
         deque(){ create_map_nodes(0);}
@@ -228,9 +489,22 @@ namespace MyStl{
         //拷贝构造
         deque(const deque& x) { copy_initialize(x.begin(), x.end()); }
         deque(const std::initializer_list<T>& il) { copy_initialize(il.begin(), il.end());}
+        //移动构造，和标准库一样先建立一个空的map再交换，被移走的x仍然是可以继续使用的空deque
+        deque(deque&& x) {
+            create_map_nodes(0);
+            swap(x);
+        }
 
         //拷贝赋值
         deque& operator=(const deque& rhs);
+        //移动赋值，清空之后交换，原来的map和缓冲区交给rhs析构
+        deque& operator=(deque&& rhs) {
+            if (&rhs != this) {
+                clear();
+                swap(rhs);
+            }
+            return *this;
+        }
 
         //析构
         ~deque(){
@@ -241,9 +515,14 @@ namespace MyStl{
 
     public:
         //元素访问
-        reference operator[](size_type n) { return start[difference_type(n)];}
+        //n一定不是负数，使用无符号数的除法和取余，缓冲区大小为2的幂时编译器会优化为移位和掩码
+        reference operator[](size_type n) {
+            const size_type offset = n + (start.cur - start.first);
+            return start.node[offset / buffer_size()][offset % buffer_size()];
+        }
         const_reference operator[](size_type n) const {
-            return start[difference_type(n)];
+            const size_type offset = n + (start.cur - start.first);
+            return start.node[offset / buffer_size()][offset % buffer_size()];
         }
         reference front() { return *start;}
         const_reference front() const { return *start;}
@@ -280,14 +559,26 @@ namespace MyStl{
         size_type size() const { return finish - start; }
         bool empty() const { return finish == start; }
         size_type max_size() const { return data_alloc::max_size(); }
+        //map中能放下的缓冲区个数
+        size_type map_capacity() const { return map_size; }
 
         //修改器
         void swap(deque& deq);
-        void push_back(const value_type& value);
-        void push_front(const value_type& value);
+        void push_back(const value_type& value) { emplace_back(value); }
+        void push_back(value_type&& value) { emplace_back(MyStl::move(value)); }
+        void push_front(const value_type& value) { emplace_front(value); }
+        void push_front(value_type&& value) { emplace_front(MyStl::move(value)); }
+        //在首尾直接用args构造元素，不产生临时对象
+        template <typename... Args>
+        void emplace_back(Args&&... args);
+        template <typename... Args>
+        void emplace_front(Args&&... args);
+        template <typename... Args>
+        iterator emplace(iterator pos, Args&&... args);
         void pop_back();
         void pop_front();
-        iterator insert(iterator pos, const value_type& value = T());
+        iterator insert(iterator pos, const value_type& value = T()) { return emplace(pos, value); }
+        iterator insert(iterator pos, value_type&& value) { return emplace(pos, MyStl::move(value)); }
         iterator insert(iterator pos, size_type n, const value_type& value);
         void insert(iterator pos, int n, const T& value){ insert(pos, size_type(n), value);}
         void insert(iterator pos, long n, const T& value){ insert(pos, size_type(n), value);}
@@ -298,10 +589,65 @@ namespace MyStl{
         void clear();
         void resize(size_type new_size, const value_type& value);
         void resize(size_type new_size) { resize(new_size, T()); }
+        //归还不需要的内存：首尾缓冲区的空位合起来超过一个缓冲区时整体前移元素少用一个缓冲区，
+        //释放备用缓冲区，再把map缩小到刚好容纳存活的缓冲区；会使所有迭代器失效
+        void shrink_to_fit();
+
+        //快照，只支持可平凡拷贝的元素：文件头之后直接使用writev写出每个缓冲区，读取时readv进新分配的缓冲区
+        void save(int fd) const;
+        void load(int fd);
     };
 
-    template<typename T>
-    void deque<T>::resize(deque::size_type new_size, const value_type &value) {
+    template<typename T, size_t BufSiz>
+    void deque<T, BufSiz>::save(int fd) const {
+        static_assert(std::is_trivially_copyable<T>::value, "deque::save requires trivially copyable T");
+        snapshot_write_header(fd, sizeof(T), size());
+        iovec iov[snapshot_iov_max];
+        int cnt = 0;
+        for (map_pointer n = start.node; n <= finish.node; ++n) {
+            pointer first = (n == start.node) ? start.cur : *n;
+            pointer last = (n == finish.node) ? finish.cur : *n + buffer_size();
+            if (first == last)
+                continue;
+            iov[cnt].iov_base = first;
+            iov[cnt].iov_len = (last - first) * sizeof(T);
+            if (++cnt == snapshot_iov_max) {
+                snapshot_writev(fd, iov, cnt);
+                cnt = 0;
+            }
+        }
+        snapshot_writev(fd, iov, cnt);
+    }
+
+    template<typename T, size_t BufSiz>
+    void deque<T, BufSiz>::load(int fd) {
+        static_assert(std::is_trivially_copyable<T>::value, "deque::load requires trivially copyable T");
+        size_type num = snapshot_read_header(fd, sizeof(T));
+        //文件头损坏时元素个数可能非常大，分配前先检查
+        if (num > max_size())
+            throw std::length_error("deque::load: element count too large");
+        //在临时deque中分配好能容纳num个元素的缓冲区，元素可平凡拷贝，所以无需构造
+        deque tmp(num, storage_only_tag());
+        iovec iov[snapshot_iov_max];
+        int cnt = 0;
+        for (map_pointer n = tmp.start.node; n <= tmp.finish.node; ++n) {
+            pointer last = (n == tmp.finish.node) ? tmp.finish.cur : *n + buffer_size();
+            if (*n == last)
+                continue;
+            iov[cnt].iov_base = *n;
+            iov[cnt].iov_len = (last - *n) * sizeof(T);
+            if (++cnt == snapshot_iov_max) {
+                snapshot_readv(fd, iov, cnt);
+                cnt = 0;
+            }
+        }
+        snapshot_readv(fd, iov, cnt);
+        //读取成功后再交换，失败时原有内容保持不变
+        swap(tmp);
+    }
+
+    template<typename T, size_t BufSiz>
+    void deque<T, BufSiz>::resize(deque::size_type new_size, const value_type &value) {
         size_type len = size();
         if (new_size < size())
             erase(start + new_size, finish);
@@ -309,8 +655,8 @@ namespace MyStl{
             insert(finish, new_size - size(), value);
     }
 
-    template<typename T>
-    void deque<T>::clear() {
+    template<typename T, size_t BufSiz>
+    void deque<T, BufSiz>::clear() {
         //clear与析构不同的地方在于，clear并不会把map给释放掉，只是析构和释放缓冲区
         //析构所有元素
         destroy(start, finish);
@@ -320,10 +666,15 @@ namespace MyStl{
         }
         start.cur = start.first;
         finish = start;
+        if (map_too_sparse(map_size, 1))
+            shrink_map(compact_map_size(1));
     }
 
-    template<typename T>
-    typename deque<T>::iterator deque<T>::erase(deque::iterator first, deque::iterator last) {
+    template<typename T, size_t BufSiz>
+    typename deque<T, BufSiz>::iterator deque<T, BufSiz>::erase(deque::iterator first, deque::iterator last) {
+        //空区间直接返回，否则下面会把元素移动给自己
+        if (first == last)
+            return first;
         if (first == start && last == finish) {
             clear();
             return finish;
@@ -331,7 +682,7 @@ namespace MyStl{
             difference_type n = last - first;
             difference_type elems_before = first - start;
             if (elems_before < (size() - n) / 2) {  //前面的元素比较少
-                std::copy_backward(start, first, last);
+                MyStl::move_backward(start, first, last);
                 iterator new_start = start + n;
                 destroy(start, new_start);
                 //将多余缓冲区释放
@@ -340,7 +691,7 @@ namespace MyStl{
                 }
                 start = new_start;
             } else {  //后面元素比较少
-                std::copy(last, finish, first);
+                MyStl::move(last, finish, first);
                 iterator new_finish = finish - n;
                 destroy(new_finish, finish);
                 for (map_pointer temp = new_finish.node + 1; temp <= finish.node; ++temp) {
@@ -352,77 +703,83 @@ namespace MyStl{
         }
     }
 
-    template<typename T>
-    typename deque<T>::iterator deque<T>::erase(deque::iterator pos) {
+    template<typename T, size_t BufSiz>
+    typename deque<T, BufSiz>::iterator deque<T, BufSiz>::erase(deque::iterator pos) {
         iterator next = pos;
         ++next;
         difference_type index = pos - start;
         if (index < (size() / 2)) {
-            std::copy_backward(start, pos, next);
+            MyStl::move_backward(start, pos, next);
             pop_front();
         } else {
-            std::copy(next, finish, pos);
+            MyStl::move(next, finish, pos);
             pop_back();
         }
         return start + index;
     }
 
-    template<typename T>
+    template<typename T, size_t BufSiz>
     template<typename InputIterator>
-    void deque<T>::insert(deque::iterator pos, InputIterator first, InputIterator last) {
+    void deque<T, BufSiz>::insert(deque::iterator pos, InputIterator first, InputIterator last) {
         std::copy(first, last, std::inserter(*this, pos));
     }
 
-    template<typename T>
-    typename deque<T>::iterator deque<T>::insert(deque::iterator pos, deque::size_type n, const value_type &value) {
+    template<typename T, size_t BufSiz>
+    typename deque<T, BufSiz>::iterator deque<T, BufSiz>::insert(deque::iterator pos, deque::size_type n, const value_type &value) {
+        const difference_type index = pos - start;
         if (pos.cur == start.cur) {
             iterator new_start = reserve_elements_at_front(n);
-            uninitialized_fill(new_start, start, value);
+            parallel_uninitialized_fill(new_start, start, value);
             start = new_start;
         } else if (pos.cur == finish.cur) {
             iterator new_finish = reserve_elements_at_back(n);
-            uninitialized_fill(finish, new_finish, value);
+            parallel_uninitialized_fill(finish, new_finish, value);
             finish = new_finish;
         } else
             insert_aux(pos, n, value);
+        return start + index;
     }
 
-    template<typename T>
-    typename deque<T>::iterator deque<T>::insert(deque::iterator pos, const value_type &value) {
+    template<typename T, size_t BufSiz>
+    template<typename... Args>
+    typename deque<T, BufSiz>::iterator deque<T, BufSiz>::emplace(deque::iterator pos, Args&&... args) {
         //先检查插入点是不是前后端
         if (pos.cur == start.cur) {
-            push_front(value);
+            emplace_front(MyStl::forward<Args>(args)...);
             return start;
         } else if (pos.cur == finish.cur) {
-            push_back(value);
+            emplace_back(MyStl::forward<Args>(args)...);
             iterator tmp = finish;
             --tmp;
             return tmp;
         } else {
-            //和insert_aux类似的操作
+            //args可能引用deque中会被移动的元素，所以先构造出新元素
+            value_type value(MyStl::forward<Args>(args)...);
+            //和insert_aux类似的操作，元素都是移动而不是复制
             difference_type index = pos - start;
             if (index < difference_type(size() / 2)){
                 //操作pos之前的数据
-                push_front(front());
+                emplace_front(MyStl::move(front()));
                 iterator old_start = start + 1;
                 iterator old_second = old_start + 1;
                 pos = start + index;
-                std::copy(old_second, pos + 1, old_start);
+                MyStl::move(old_second, pos + 1, old_start);
             } else{
                 //操作pos后面的数据
-                push_back(back());
+                emplace_back(MyStl::move(back()));
                 iterator old_finish = finish - 1;
                 iterator old_finish2 = old_finish - 1;
                 pos = start + index;
-                std::copy_backward(pos, old_finish2, old_finish);
+                MyStl::move_backward(pos, old_finish2, old_finish);
             }
             //因为是已经构造好的空间，所以直接使用operator=即可
-            *pos = value;
+            *pos = MyStl::move(value);
+            return pos;
         }
     }
 
-    template <typename T>
-    void deque<T>::pop_back() {
+    template<typename T, size_t BufSiz>
+    void deque<T, BufSiz>::pop_back() {
         //要先判断最后一个缓冲区有没有元素，如果没有则需要负责释放最后的缓冲区
         if (finish.cur != finish.first) {
             --finish.cur;
@@ -435,8 +792,8 @@ namespace MyStl{
         }
     }
 
-    template <typename T>
-    void deque<T>::pop_front() {
+    template<typename T, size_t BufSiz>
+    void deque<T, BufSiz>::pop_front() {
         destroy(start.cur);
         if (start.cur != start.last - 1) {
             ++start.cur;
@@ -447,34 +804,34 @@ namespace MyStl{
         }
     }
 
-    template<typename T>
-    void deque<T>::push_front(const value_type &value) {
+    template<typename T, size_t BufSiz>
+    template<typename... Args>
+    void deque<T, BufSiz>::emplace_front(Args&&... args) {
         if (start.cur != start.first) {
-            --start;
-            construct(start.cur, value);
+            MyStl::construct(start.cur - 1, MyStl::forward<Args>(args)...);
+            --start.cur;
         } else {
-            //和push_back的实现相比更底层的写法，相对于把reserve_elements_at_back重写了一遍
+            //和emplace_back的实现相比更底层的写法，相对于把reserve_elements_at_front重写了一遍
             reserve_map_at_front();
             *(start.node - 1) = allocate_node();
             try {
-                start.set_node(start.node - 1);
-                start.cur = start.last - 1;
-                construct(start.cur, value);
+                MyStl::construct(*(start.node - 1) + buffer_size() - 1, MyStl::forward<Args>(args)...);
             } catch (...) {
-                //注意push_front的catch部分和push_back的不同
-                //因为错误只能发生在construct的过程种，而这个时候start已经set_node了，所以我们需要先回退一步
-                start.set_node(start.node + 1);
-                start.cur = start.first;
+                //构造失败时start还没有移动，只需要释放新缓冲区
                 deallocate_node(*(start.node - 1));
+                throw;
             }
+            start.set_node(start.node - 1);
+            start.cur = start.last - 1;
         }
     }
 
-    template<typename T>
-    void deque<T>::push_back(const value_type &value) {
+    template<typename T, size_t BufSiz>
+    template<typename... Args>
+    void deque<T, BufSiz>::emplace_back(Args&&... args) {
         if (finish.cur != finish.last - 1) {
-            construct(finish.cur, value);
-            ++finish;
+            MyStl::construct(finish.cur, MyStl::forward<Args>(args)...);
+            ++finish.cur;
         } else {
             //insert_aux(end(), 1, value);
             //直接用insert_aux或者
@@ -485,61 +842,64 @@ namespace MyStl{
             reserve_map_at_back();
             *(finish.node + 1) = allocate_node();
             try {
-                construct(finish.cur, value);
-                finish.set_node(finish.node + 1);
-                finish.cur = finish.first;
+                MyStl::construct(finish.cur, MyStl::forward<Args>(args)...);
             } catch (...) {
                 deallocate_node(*(finish.node + 1));
+                throw;
             }
+            finish.set_node(finish.node + 1);
+            finish.cur = finish.first;
         }
     }
 
-    template<typename T>
-    void deque<T>::swap(deque &deq) {
+    template<typename T, size_t BufSiz>
+    void deque<T, BufSiz>::swap(deque &deq) {
         std::swap(map, deq.map);
         std::swap(map_size, deq.map_size);
         std::swap(start, deq.start);
         std::swap(finish, deq.finish);
+        //备用缓冲区的大小都相同，所以不需要交换，各自保留即可
     }
 
-    template<typename T>
-    deque<T> &deque<T>::operator=(const deque &rhs) {
+    template<typename T, size_t BufSiz>
+    deque<T, BufSiz> &deque<T, BufSiz>::operator=(const deque &rhs) {
         if (&rhs != this){
             const size_type len = size();
             if (len >= rhs.size()) {
-                erase(std::copy(rhs.begin(), rhs.end(), start), finish);
+                erase(MyStl::copy(rhs.begin(), rhs.end(), start), finish);
             } else {
                 const_iterator mid = rhs.begin() + difference_type(len);
-                std::copy(rhs.begin(), mid, start);
+                MyStl::copy(rhs.begin(), mid, start);
                 insert(finish, mid, rhs.end());
             }
         }
         return *this;
     }
 
-    template<typename T>
+    template<typename T, size_t BufSiz>
     template<typename InputIterator>
-    void deque<T>::copy_initialize(InputIterator first, InputIterator last) {
+    void deque<T, BufSiz>::copy_initialize(InputIterator first, InputIterator last) {
         create_map_nodes(0);
         for (; first != last; ++first)
             push_back(*first);
     }
 
-    template<typename T>
-    void deque<T>::destroy_nodes_at_back(deque::iterator after_finish) {
+    template<typename T, size_t BufSiz>
+    void deque<T, BufSiz>::destroy_nodes_at_back(deque::iterator after_finish) {
         for (map_pointer n = after_finish.node; n > finish.node; --n)
             deallocate_node(*n);
     }
 
-    template<typename T>
-    void deque<T>::destroy_nodes_at_front(deque::iterator before_start) {
+    template<typename T, size_t BufSiz>
+    void deque<T, BufSiz>::destroy_nodes_at_front(deque::iterator before_start) {
         for (map_pointer n = before_start.node; n < start.node; ++n)
             deallocate_node(*n);
     }
 
-    template<typename T>
-    typename deque<T>::iterator deque<T>::reserve_elements_at_back(deque::size_type n) {
-        size_type remain = finish.last - finish.cur;
+    template<typename T, size_t BufSiz>
+    typename deque<T, BufSiz>::iterator deque<T, BufSiz>::reserve_elements_at_back(deque::size_type n) {
+        //finish.cur不能停在缓冲区末尾，所以最后一个缓冲区只有last - cur - 1个空位
+        size_type remain = finish.last - finish.cur - 1;
         if (n > remain) {
             size_type new_elements = n - remain;
             size_type new_nodes = (new_elements - 1) / buffer_size() + 1;
@@ -547,7 +907,7 @@ namespace MyStl{
             size_type i;
             try {
                 for (i = 1; i <= new_nodes; ++i) {
-                    *(finish.node + 1) = allocate_node();
+                    *(finish.node + i) = allocate_node();
                 }
             } catch (...) {
                 for (size_type j = 1; j < i ; ++j) {
@@ -559,8 +919,8 @@ namespace MyStl{
         return finish + difference_type(n);
     }
 
-    template<typename T>
-    typename deque<T>::iterator deque<T>::reserve_elements_at_front(deque::size_type n) {
+    template<typename T, size_t BufSiz>
+    typename deque<T, BufSiz>::iterator deque<T, BufSiz>::reserve_elements_at_front(deque::size_type n) {
         //start缓冲区空余的位置
         size_type remain = start.cur - start.first;
         //如果需要创建的元素数目比空余的多，那么就需要分配多的map节点
@@ -575,7 +935,7 @@ namespace MyStl{
             size_type i;
             try {
                 for (i = 1; i <= new_nodes; ++i) {
-                    *(start.node - 1) = allocate_node();
+                    *(start.node - i) = allocate_node();
                 }
             } catch (...) {
                 for (size_type j = 1; j < i ; ++j) {
@@ -588,8 +948,10 @@ namespace MyStl{
         return start - difference_type(n);
     }
 
-    template<typename T>
-    void deque<T>::insert_aux(deque::iterator pos, deque::size_type n, const value_type &value) {
+    template<typename T, size_t BufSiz>
+    void deque<T, BufSiz>::insert_aux(deque::iterator pos, deque::size_type n, const value_type &x) {
+        //x可能引用deque中会被移动的元素，先复制一份
+        const value_type value(x);
         const difference_type elems_before = pos - start;
         size_type length = size();
         //如果pos之前的元素数目比较少，那么就从前面开始插入，否则从后面开始
@@ -603,21 +965,22 @@ namespace MyStl{
                 if (elems_before >= n){
                     iterator start_n = start + n;
                     //因为新分配的缓冲区是未构造的，所以要使用uninitialized_copy进行构造
-                    uninitialized_copy(start, start_n, new_start);
-                    //对于原有的已构造缓冲区，则只需要copy
+                    MyStl::uninitialized_move(start, start_n, new_start);
+                    //对于原有的已构造缓冲区，则只需要移动赋值
                     start = new_start;
-                    std::copy(start_n, pos, old_start);
+                    MyStl::move(start_n, pos, old_start);
                     //完成插入
-                    std::fill(pos - n, pos, value);
+                    MyStl::fill(pos - n, pos, value);
                 } else {
-                    iterator mid = uninitialized_copy(start, pos, new_start);
-                    uninitialized_fill(mid, start, value);
+                    iterator mid = MyStl::uninitialized_move(start, pos, new_start);
+                    MyStl::uninitialized_fill(mid, start, value);
                     start = new_start;
-                    uninitialized_fill(old_start, pos, value);
+                    MyStl::uninitialized_fill(old_start, pos, value);
                 }
             } catch (...) {
                 //分配失败则要释放内存，析构已经在uninitialized函数中实现了
                 destroy_nodes_at_front(new_start);
+                throw;
             }
         } else {
             iterator new_finish = reserve_elements_at_back(n);
@@ -629,31 +992,78 @@ namespace MyStl{
             try {
                 if (elems_after > n) {
                     iterator finish_n = finish - n;
-                    uninitialized_copy(finish_n, finish, finish);
+                    MyStl::uninitialized_move(finish_n, finish, finish);
                     finish = new_finish;
-                    std::copy_backward(pos, finish_n, old_finish);
-                    std::fill(pos, pos + n, value);
+                    MyStl::move_backward(pos, finish_n, old_finish);
+                    MyStl::fill(pos, pos + n, value);
                 } else {
-                    uninitialized_fill(finish, pos + n, value);
-                    uninitialized_copy(pos, finish, pos + n);
+                    MyStl::uninitialized_fill(finish, pos + n, value);
+                    MyStl::uninitialized_move(pos, finish, pos + n);
                     finish = new_finish;
-                    std::fill(pos, old_finish, value);
+                    MyStl::fill(pos, old_finish, value);
                 }
             } catch (...) {
                 destroy_nodes_at_back(new_finish);
+                throw;
             }
 
         }
     }
 
-    template<typename T>
-    void deque<T>::reallocate_map(deque::size_type nodes_to_add, bool add_at_front) {
+    template<typename T, size_t BufSiz>
+    void deque<T, BufSiz>::shrink_map(deque::size_type new_map_size) {
+        if (new_map_size >= map_size)
+            return;
+        const size_type nodes = finish.node - start.node + 1;
+        map_pointer new_map;
+        try {
+            new_map = map_alloc::allocate(new_map_size);
+        } catch (...) {
+            return;
+        }
+        map_pointer new_nstart = new_map + (new_map_size - nodes) / 2;
+        std::copy(start.node, finish.node + 1, new_nstart);
+        map_alloc::deallocate(map, map_size);
+        map = new_map;
+        map_size = new_map_size;
+        //和reallocate_map一样，set_node保留了cur
+        start.set_node(new_nstart);
+        finish.set_node(new_nstart + nodes - 1);
+    }
+
+    template<typename T, size_t BufSiz>
+    void deque<T, BufSiz>::shrink_to_fit() {
+        //size个元素最少需要size / buffer_size() + 1个缓冲区(finish.cur不能停在缓冲区末尾)
+        if (size() / buffer_size() + 1 < size_type(finish.node - start.node + 1)) {
+            //目标区间在源区间之前，从前向后移动不会覆盖还没有移动的元素
+            //start之前的gap个位置还没有构造，先移动构造这部分，其余的移动赋值
+            const size_type n = size();
+            const size_type gap = start.cur - start.first;
+            const size_type m = std::min(n, gap);
+            iterator new_start(start.first, start.node);
+            MyStl::uninitialized_move(start, start + m, new_start);
+            iterator new_finish = MyStl::move(start + m, finish, new_start + m);
+            //n < gap时[new_finish, start)从未构造过，只析构原来的元素
+            destroy(n < gap ? start : new_finish, finish);
+            for (map_pointer node = new_finish.node + 1; node <= finish.node; ++node)
+                deallocate_node(*node);
+            start = new_start;
+            finish = new_finish;
+        }
+        release_spare_nodes();
+        //两端各留一个空位，之后在任意一端跨越缓冲区时不需要马上重新分配map
+        shrink_map(std::max(init_map_size(), size_type(finish.node - start.node + 1) + 2));
+    }
+
+    template<typename T, size_t BufSiz>
+    void deque<T, BufSiz>::reallocate_map(deque::size_type nodes_to_add, bool add_at_front) {
         size_type old_nodes_num = finish.node - start.node + 1;
         size_type new_nodes_num = old_nodes_num + nodes_to_add;
         map_pointer new_nstart;
 
         /* 如果旧map的size大于2倍实际需要的缓冲区节点数（即map有一半还没有用到） */
-        if (map_size > 2 * new_nodes_num){
+        //但是map过于稀疏时(例如队列的高峰过去之后)，不重新居中，而是换成更小的map
+        if (map_size > 2 * new_nodes_num && !map_too_sparse(map_size, new_nodes_num)){
             //将当前map重新规划，使得已经构造好的node放在map的中间，使得两边可扩充的区域重新一致
             new_nstart = map + (map_size - new_nodes_num) / 2 +
                          (add_at_front ? nodes_to_add : 0);
@@ -663,12 +1073,13 @@ namespace MyStl{
             else
                 //否则是push_front引发的扩容
                 std::copy_backward(start.node, finish.node + 1,
-                                   new_nstart + new_nodes_num);
+                                   new_nstart + old_nodes_num);
         } else {
             /*真的空间不够了，重新分配一块map内存，并把节点copy过去*/
             //如果自定义加的node空间比原空间少，那么就扩容到原来的两倍
-            size_type new_map_size =
-                    map_size + std::max(map_size, nodes_to_add) + 2;
+            size_type new_map_size = map_size > 2 * new_nodes_num
+                                     ? compact_map_size(new_nodes_num)
+                                     : map_size + std::max(map_size, nodes_to_add) + 2;
             map_pointer new_map = map_alloc::allocate(new_map_size);
             new_nstart = new_map + (new_map_size - new_nodes_num) / 2 +
                          (add_at_front ? nodes_to_add : 0);
@@ -686,36 +1097,48 @@ namespace MyStl{
     }
 
 
-    template<typename T>
-    void deque<T>::fill_initialize(deque::size_type n, const value_type &value) {
+    template<typename T, size_t BufSiz>
+    void deque<T, BufSiz>::fill_initialize(deque::size_type n, const value_type &value) {
         //allocate内存，创建map结构
         create_map_nodes(n);
+        //元素很多时，把整个区间交给线程池并行构造，失败时已构造的部分会被析构
+        if (use_parallel<value_type>(n)) {
+            try {
+                parallel_uninitialized_fill(start, finish, value);
+            } catch (...) {
+                destroy_map_nodes();
+                throw;
+            }
+            return;
+        }
         map_pointer cur;
         try {
             for (cur = start.node; cur < finish.node ; ++cur)
-                uninitialized_fill(*cur, *cur + buffer_size(), value);
-            uninitialized_fill(finish.first, finish.cur, value);
+                MyStl::uninitialized_fill(*cur, *cur + buffer_size(), value);
+            MyStl::uninitialized_fill(finish.first, finish.cur, value);
         } catch (...){
             //如果出现异常，cur当前的uninitialized_fill会处理该缓冲区的析构问题
             //所以我们需要做的是析构已经构造好的缓冲区，然后释放空间
             for (map_pointer n = start.node; n < cur; ++n)
                 destroy(*n, *n + buffer_size());
             destroy_map_nodes();
+            throw;
         }
     }
 
-    template<typename T>
-    void deque<T>::destroy_map_nodes() {
+    template<typename T, size_t BufSiz>
+    void deque<T, BufSiz>::destroy_map_nodes() {
         //因为分配的时候是一个缓冲区一个缓冲区分配的，所以摧毁的时候也是同理
         //先摧毁缓冲区，再摧毁map
         for (map_pointer temp = start.node; temp <= finish.node; ++temp) {
             deallocate_node(*temp);
         }
+        release_spare_nodes();
         map_alloc::deallocate(map, map_size);
     }
 
-    template<typename T>
-    void deque<T>::create_map_nodes(deque::size_type num_element) {
+    template<typename T, size_t BufSiz>
+    void deque<T, BufSiz>::create_map_nodes(deque::size_type num_element) {
         //节点的个数
         size_type num_nodes = num_element / buffer_size() + 1;
         map_size = std::max(init_map_size(), num_nodes + 2);
@@ -732,6 +1155,7 @@ namespace MyStl{
         } catch (...) {
             for (map_pointer tmp = nstart; tmp < cur; ++tmp)
                 deallocate_node(*tmp);
+            release_spare_nodes();
             map_alloc::deallocate(map, map_size);
             throw;
         }
@@ -0,0 +1,417 @@
+
+#ifndef MYSTL_DYNAMIC_BITSET_H
+#define MYSTL_DYNAMIC_BITSET_H
+
+//按位压缩的动态位图。vector<bool>每个标志占一个字节，这里每个标志只占一位，内存是原来的1/8
+//以64位字为单位存储和计算：count、find_first/find_next以及与或异或等批量操作都是逐字进行的
+//在x86上运行时检测CPU，支持时使用POPCNT/AVX2版本的计算函数
+#include <cstdint>
+#include <cstring>
+#include "pool_allocator.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MYSTL_BITSET_X86 1
+#include <immintrin.h>
+#endif
+
+namespace MyStl{
+    /*逐字计算的函数，通用版本*/
+    inline size_t bit_popcount(uint64_t w) {
+#if defined(__GNUC__)
+        return size_t(__builtin_popcountll(w));
+#else
+        size_t n = 0;
+        for (; w; w &= w - 1)
+            ++n;
+        return n;
+#endif
+    }
+
+    //最低位的1的位置，w不能为0
+    inline size_t bit_ctz(uint64_t w) {
+#if defined(__GNUC__)
+        return size_t(__builtin_ctzll(w));
+#else
+        size_t n = 0;
+        for (; !(w & 1); w >>= 1)
+            ++n;
+        return n;
+#endif
+    }
+
+    inline size_t bits_count_generic(const uint64_t* w, size_t n) {
+        size_t total = 0;
+        for (size_t i = 0; i < n; ++i)
+            total += bit_popcount(w[i]);
+        return total;
+    }
+    inline void bits_and_generic(uint64_t* dst, const uint64_t* src, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] &= src[i];
+    }
+    inline void bits_or_generic(uint64_t* dst, const uint64_t* src, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] |= src[i];
+    }
+    inline void bits_xor_generic(uint64_t* dst, const uint64_t* src, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] ^= src[i];
+    }
+    inline void bits_andnot_generic(uint64_t* dst, const uint64_t* src, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] &= ~src[i];
+    }
+
+#ifdef MYSTL_BITSET_X86
+    /*x86版本，使用target属性单独编译，运行时确认CPU支持后才会被调用*/
+    __attribute__((target("popcnt")))
+    inline size_t bits_count_popcnt(const uint64_t* w, size_t n) {
+        size_t total = 0;
+        for (size_t i = 0; i < n; ++i)
+            total += size_t(__builtin_popcountll(w[i]));
+        return total;
+    }
+
+    //AVX2版本的popcount：用vpshufb查4位的表，再用vpsadbw把每8个字节的计数加起来
+    __attribute__((target("avx2,popcnt")))
+    inline size_t bits_count_avx2(const uint64_t* w, size_t n) {
+        const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i low_mask = _mm256_set1_epi8(0x0f);
+        __m256i acc = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+            __m256i lo = _mm256_and_si256(v, low_mask);
+            __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+            __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+            acc = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+        }
+        uint64_t lanes[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+        size_t total = size_t(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+        for (; i < n; ++i)
+            total += size_t(__builtin_popcountll(w[i]));
+        return total;
+    }
+
+#define MYSTL_BITSET_AVX2_BINARY(name, expr)                                               \
+    __attribute__((target("avx2")))                                                       \
+    inline void name(uint64_t* dst, const uint64_t* src, size_t n) {                      \
+        size_t i = 0;                                                                      \
+        for (; i + 4 <= n; i += 4) {                                                       \
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));    \
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));    \
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), expr);               \
+        }                                                                                  \
+        for (; i < n; ++i) {                                                               \
+            uint64_t a = dst[i], b = src[i];                                               \
+            dst[i] = name##_tail(a, b);                                                    \
+        }                                                                                  \
+    }
+
+    inline uint64_t bits_and_avx2_tail(uint64_t a, uint64_t b) { return a & b; }
+    inline uint64_t bits_or_avx2_tail(uint64_t a, uint64_t b) { return a | b; }
+    inline uint64_t bits_xor_avx2_tail(uint64_t a, uint64_t b) { return a ^ b; }
+    inline uint64_t bits_andnot_avx2_tail(uint64_t a, uint64_t b) { return a & ~b; }
+
+    MYSTL_BITSET_AVX2_BINARY(bits_and_avx2, _mm256_and_si256(a, b))
+    MYSTL_BITSET_AVX2_BINARY(bits_or_avx2, _mm256_or_si256(a, b))
+    MYSTL_BITSET_AVX2_BINARY(bits_xor_avx2, _mm256_xor_si256(a, b))
+    //_mm256_andnot_si256(x, y) 计算的是 ~x & y
+    MYSTL_BITSET_AVX2_BINARY(bits_andnot_avx2, _mm256_andnot_si256(b, a))
+
+#undef MYSTL_BITSET_AVX2_BINARY
+#endif
+
+    //运行时选择的计算函数，第一次使用时根据CPU确定
+    struct bit_kernels{
+        using count_fn = size_t (*)(const uint64_t*, size_t);
+        using binary_fn = void (*)(uint64_t*, const uint64_t*, size_t);
+
+        count_fn count;
+        binary_fn and_op;
+        binary_fn or_op;
+        binary_fn xor_op;
+        binary_fn andnot_op;
+
+        static const bit_kernels& get() {
+            static const bit_kernels k = select();
+            return k;
+        }
+
+    private:
+        static bit_kernels select() {
+            bit_kernels k = {bits_count_generic, bits_and_generic, bits_or_generic,
+                             bits_xor_generic, bits_andnot_generic};
+#ifdef MYSTL_BITSET_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("popcnt"))
+                k.count = bits_count_popcnt;
+            if (__builtin_cpu_supports("avx2")) {
+                k.and_op = bits_and_avx2;
+                k.or_op = bits_or_avx2;
+                k.xor_op = bits_xor_avx2;
+                k.andnot_op = bits_andnot_avx2;
+                if (__builtin_cpu_supports("popcnt"))
+                    k.count = bits_count_avx2;
+            }
+#endif
+            return k;
+        }
+    };
+
+    //C++11中static constexpr成员被odr-use(例如绑定到const&)时需要类外定义
+    //dynamic_bitset不是模板，类外定义写在头文件中会在多个编译单元中重复，所以放在类模板里
+    template <typename Dummy = void>
+    struct dynamic_bitset_constants{
+        static constexpr size_t npos = size_t(-1);
+    };
+    template <typename Dummy>
+    constexpr size_t dynamic_bitset_constants<Dummy>::npos;
+
+    class dynamic_bitset : public dynamic_bitset_constants<>{
+    public:
+        using word_type = uint64_t;
+        using size_type = size_t;
+        using word_alloc = pool_alloc<word_type>;
+
+        enum { word_bits = 64 };
+
+        //代理引用，operator[]无法返回一位的引用，所以返回这个对象
+        class reference{
+            friend class dynamic_bitset;
+            word_type* word;
+            word_type mask;
+            reference(word_type* w, size_type pos) : word(w), mask(word_type(1) << pos) {}
+        public:
+            operator bool() const { return (*word & mask) != 0; }
+            bool operator~() const { return (*word & mask) == 0; }
+            reference& operator=(bool value) {
+                if (value)
+                    *word |= mask;
+                else
+                    *word &= ~mask;
+                return *this;
+            }
+            reference& operator=(const reference& rhs) { return *this = bool(rhs); }
+            reference& flip() {
+                *word ^= mask;
+                return *this;
+            }
+        };
+
+    protected:
+        word_type* words;
+        size_type nbits;
+        size_type cap_words;
+
+        static size_type words_for(size_type n) { return (n + word_bits - 1) / word_bits; }
+        size_type num_used() const { return words_for(nbits); }
+        //最后一个字中超出size的位必须始终为0，count和find依赖这一点
+        void clear_unused_bits() {
+            if (nbits % word_bits)
+                words[nbits / word_bits] &= (word_type(1) << (nbits % word_bits)) - 1;
+        }
+        void reallocate(size_type new_words);
+        //对前n个字执行批量操作，并保证多出来的位为0
+        void apply(bit_kernels::binary_fn op, const dynamic_bitset& rhs) {
+            size_type n = num_used() < rhs.num_used() ? num_used() : rhs.num_used();
+            op(words, rhs.words, n);
+            clear_unused_bits();
+        }
+
+    public:
+        //构造与析构
+        dynamic_bitset() : words(nullptr), nbits(0), cap_words(0) {}
+        explicit dynamic_bitset(size_type n, bool value = false) : words(nullptr), nbits(0), cap_words(0) {
+            resize(n, value);
+        }
+        dynamic_bitset(const dynamic_bitset& rhs) : words(nullptr), nbits(0), cap_words(0) {
+            reallocate(rhs.num_used());
+            if (rhs.num_used())
+                std::memcpy(words, rhs.words, rhs.num_used() * sizeof(word_type));
+            nbits = rhs.nbits;
+        }
+        dynamic_bitset& operator=(const dynamic_bitset& rhs) {
+            dynamic_bitset temp(rhs);
+            swap(temp);
+            return *this;
+        }
+        ~dynamic_bitset() {
+            if (words)
+                word_alloc::deallocate(words, cap_words);
+        }
+
+        //元素访问
+        reference operator[](size_type pos) { return reference(words + pos / word_bits, pos % word_bits); }
+        bool operator[](size_type pos) const { return test(pos); }
+        bool test(size_type pos) const { return (words[pos / word_bits] >> (pos % word_bits)) & 1; }
+        word_type* data() { return words; }
+        const word_type* data() const { return words; }
+
+        //容量
+        size_type size() const { return nbits; }
+        bool empty() const { return nbits == 0; }
+        size_type capacity() const { return cap_words * word_bits; }
+        size_type num_words() const { return num_used(); }
+        void reserve(size_type n) {
+            if (words_for(n) > cap_words)
+                reallocate(words_for(n));
+        }
+
+        //修改器
+        dynamic_bitset& set(size_type pos, bool value = true) {
+            (*this)[pos] = value;
+            return *this;
+        }
+        dynamic_bitset& reset(size_type pos) { return set(pos, false); }
+        dynamic_bitset& flip(size_type pos) {
+            words[pos / word_bits] ^= word_type(1) << (pos % word_bits);
+            return *this;
+        }
+        dynamic_bitset& set() {
+            if (num_used())
+                std::memset(words, 0xff, num_used() * sizeof(word_type));
+            clear_unused_bits();
+            return *this;
+        }
+        dynamic_bitset& reset() {
+            if (num_used())
+                std::memset(words, 0, num_used() * sizeof(word_type));
+            return *this;
+        }
+        dynamic_bitset& flip() {
+            for (size_type i = 0; i < num_used(); ++i)
+                words[i] = ~words[i];
+            clear_unused_bits();
+            return *this;
+        }
+        void push_back(bool value);
+        void pop_back() {
+            --nbits;
+            clear_unused_bits();
+        }
+        void resize(size_type n, bool value = false);
+        void clear() { nbits = 0; }
+        void swap(dynamic_bitset& rhs) {
+            std::swap(words, rhs.words);
+            std::swap(nbits, rhs.nbits);
+            std::swap(cap_words, rhs.cap_words);
+        }
+
+        //查询
+        size_type count() const { return bit_kernels::get().count(words, num_used()); }
+        bool any() const {
+            for (size_type i = 0; i < num_used(); ++i)
+                if (words[i])
+                    return true;
+            return false;
+        }
+        bool none() const { return !any(); }
+        bool all() const { return count() == nbits; }
+        //返回第一个为1的位，没有则返回npos
+        size_type find_first() const { return find_from(0); }
+        //返回pos之后第一个为1的位，没有则返回npos
+        size_type find_next(size_type pos) const { return pos + 1 >= nbits ? npos : find_from(pos + 1); }
+        size_type find_from(size_type pos) const;
+
+        //批量操作，两个位图长度不同时只对重叠部分操作（&会把多出来的部分清零）
+        dynamic_bitset& operator&=(const dynamic_bitset& rhs) {
+            apply(bit_kernels::get().and_op, rhs);
+            if (num_used() > rhs.num_used())
+                std::memset(words + rhs.num_used(), 0, (num_used() - rhs.num_used()) * sizeof(word_type));
+            return *this;
+        }
+        dynamic_bitset& operator|=(const dynamic_bitset& rhs) {
+            apply(bit_kernels::get().or_op, rhs);
+            return *this;
+        }
+        dynamic_bitset& operator^=(const dynamic_bitset& rhs) {
+            apply(bit_kernels::get().xor_op, rhs);
+            return *this;
+        }
+        //this &= ~rhs，即集合的差
+        dynamic_bitset& and_not(const dynamic_bitset& rhs) {
+            apply(bit_kernels::get().andnot_op, rhs);
+            return *this;
+        }
+        dynamic_bitset operator~() const {
+            dynamic_bitset r(*this);
+            return r.flip();
+        }
+
+        bool operator==(const dynamic_bitset& rhs) const {
+            return nbits == rhs.nbits
+                   && (num_used() == 0 || std::memcmp(words, rhs.words, num_used() * sizeof(word_type)) == 0);
+        }
+        bool operator!=(const dynamic_bitset& rhs) const { return !(*this == rhs); }
+    };
+
+    inline void dynamic_bitset::reallocate(size_type new_words) {
+        word_type* new_start = word_alloc::allocate(new_words);
+        if (num_used())
+            std::memcpy(new_start, words, num_used() * sizeof(word_type));
+        if (words)
+            word_alloc::deallocate(words, cap_words);
+        words = new_start;
+        cap_words = new_words;
+    }
+
+    inline void dynamic_bitset::push_back(bool value) {
+        if (nbits == cap_words * word_bits)
+            //与vector相同的增长策略
+            reallocate(cap_words == 0 ? 1 : 2 * cap_words);
+        if (nbits % word_bits == 0)
+            words[nbits / word_bits] = 0;
+        ++nbits;
+        set(nbits - 1, value);
+    }
+
+    inline void dynamic_bitset::resize(size_type n, bool value) {
+        if (n <= nbits) {
+            nbits = n;
+            clear_unused_bits();
+            return;
+        }
+        reserve(n);
+        size_type old_words = num_used();
+        //新增的整字直接填充，原来最后一个字中未使用的位单独设置
+        word_type fill = value ? ~word_type(0) : 0;
+        for (size_type i = old_words; i < words_for(n); ++i)
+            words[i] = fill;
+        if (value && nbits % word_bits)
+            words[nbits / word_bits] |= ~((word_type(1) << (nbits % word_bits)) - 1);
+        nbits = n;
+        clear_unused_bits();
+    }
+
+    inline dynamic_bitset::size_type dynamic_bitset::find_from(size_type pos) const {
+        if (pos >= nbits)
+            return npos;
+        size_type i = pos / word_bits;
+        word_type w = words[i] & (~word_type(0) << (pos % word_bits));
+        for (;;) {
+            if (w)
+                return i * word_bits + bit_ctz(w);
+            if (++i >= num_used())
+                return npos;
+            w = words[i];
+        }
+    }
+
+    inline dynamic_bitset operator&(const dynamic_bitset& lhs, const dynamic_bitset& rhs) {
+        dynamic_bitset r(lhs);
+        return r &= rhs;
+    }
+    inline dynamic_bitset operator|(const dynamic_bitset& lhs, const dynamic_bitset& rhs) {
+        dynamic_bitset r(lhs);
+        return r |= rhs;
+    }
+    inline dynamic_bitset operator^(const dynamic_bitset& lhs, const dynamic_bitset& rhs) {
+        dynamic_bitset r(lhs);
+        return r ^= rhs;
+    }
+}
+
+#endif //MYSTL_DYNAMIC_BITSET_H
@@ -3,6 +3,8 @@
 #define MYSTL_HEAP_H
 
 //heap.h不属于标准库的部分，为建堆和维护最大堆的相关算法，为设计优先队列打下基础
+//调整过程中元素都是移动而不是复制，洞值按值传入，避免引用到被覆盖的位置
+#include "move.h"
 namespace MyStl {
 
     //向上调整法
@@ -10,17 +12,17 @@ namespace MyStl {
     void push_heap_aux(RandomAccessIterator first,                  //容器起始位置
                        Distance holeIndex,                          //洞号，及子节点的位置
                        Distance topIndex,                           //父节点的位置
-                       const T& value) {                            //子节点的值
+                       T value) {                                   //子节点的值
         //找到父节点
         Distance parent = (holeIndex - 1) / 2;
         //如果还未到达顶端，并且父节点的值小于子节点，那么就交换
         while(holeIndex > topIndex && *(first + parent) < value) {
-            *(first + holeIndex) = *(first + parent);
+            *(first + holeIndex) = MyStl::move(*(first + parent));
             holeIndex = parent;
             parent = (holeIndex - 1) / 2;
         }
         //子节点进无可进，说明已经满足了最大堆的条件，父节点大于子节点。
-        *(first + holeIndex) = value;
+        *(first + holeIndex) = MyStl::move(value);
     }
 
     //向下调整法
@@ -28,7 +30,7 @@ namespace MyStl {
     void pop_heap_aux(RandomAccessIterator first,
                       Distance holeIndex,           //需要向下调整的节点
                       Distance len,                 //堆的长度
-                      const T& value) {
+                      T value) {
         //找到右子节点
         Distance largeChild = holeIndex * 2 + 2;
         while (largeChild < len ){
@@ -38,7 +40,7 @@ namespace MyStl {
             //比较父子，如果满足大堆，则退出。否则交换
             if (*(first + largeChild) < value)
                 break;
-            *(first + holeIndex) = *(first + largeChild);
+            *(first + holeIndex) = MyStl::move(*(first + largeChild));
             holeIndex = largeChild;                 //交换完毕, 大子节点成为新的洞值
             largeChild = holeIndex * 2 + 2;         //计算新的右子节点
         }
@@ -46,12 +48,12 @@ namespace MyStl {
         //这时候需要比较洞值和子节点
         if (largeChild == len) {
             if (value < *(first + largeChild - 1)){
-                *(first + holeIndex) = *(first + largeChild - 1);
+                *(first + holeIndex) = MyStl::move(*(first + largeChild - 1));
                 holeIndex = largeChild - 1;
             }
         }
         //以上流程结束后，洞值下无可下，填充洞值
-        *(first + holeIndex) = value;
+        *(first + holeIndex) = MyStl::move(value);
     }
 
      /*heap算法接口*/
@@ -62,10 +64,9 @@ namespace MyStl {
      template<typename RandomAccessIterator>
      void push_heap(RandomAccessIterator first,
                     RandomAccessIterator last) {
-         auto value = *(last - 1);
          auto holeIndex = (last - first) - 1;
          decltype(holeIndex) topIndex = 0;
-         push_heap_aux(first, holeIndex, topIndex, value);
+         push_heap_aux(first, holeIndex, topIndex, MyStl::move(*(last - 1)));
      }
 
      //pop_heap 使top元素放到容器末尾，同时剩余数据满足最大堆结构
@@ -79,9 +80,9 @@ namespace MyStl {
          auto len = (last - first) - 1;
          decltype(len) holeIndex = 0;
          //首位元素互换，top的位置为洞号
-         auto value = *(last - 1);
-         *(last - 1) = *first;
-         pop_heap_aux(first, holeIndex, len, value);
+         auto value = MyStl::move(*(last - 1));
+         *(last - 1) = MyStl::move(*first);
+         pop_heap_aux(first, holeIndex, len, MyStl::move(value));
      }
 
     //make_heap 使堆的底层容器满足堆的要求
@@ -95,7 +96,7 @@ namespace MyStl {
         decltype(len) holeIndex = (len - 2) / 2;
         while (holeIndex >= 0) {
             //len指的是最大下标
-            pop_heap_aux(first, holeIndex, len, *(first + holeIndex));
+            pop_heap_aux(first, holeIndex, len, MyStl::move(*(first + holeIndex)));
             --holeIndex;
         }
     }
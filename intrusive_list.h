@@ -0,0 +1,225 @@
+
+#ifndef MYSTL_INTRUSIVE_LIST_H
+#define MYSTL_INTRUSIVE_LIST_H
+
+//侵入式链表：链表指针作为list_hook成员嵌在对象内部，链表只负责链接，不分配节点也不拷贝、析构对象
+//对象已经存在时(会话、定时器等)，放进list需要为每个元素分配一个节点并拷贝一份，intrusive_list直接链接对象本身
+//push/pop/erase不分配内存；已知对象时通过iterator_to或erase(T&)在O(1)内定位和摘下
+//对象的生命周期由使用者管理，对象析构或移动前必须先从链表中摘下；一个hook同一时间只能在一个链表中
+//指针的修改复用list.h中的link_transfer
+#include "iterator.h"
+#include "list.h"
+
+namespace MyStl{
+    //嵌在对象中的链表指针，不在任何链表中时为空
+    struct list_hook{
+        list_hook* next;
+        list_hook* prev;
+
+        list_hook() : next(nullptr), prev(nullptr) {}
+        //拷贝对象时不拷贝链接关系，新对象不在任何链表中
+        list_hook(const list_hook&) : next(nullptr), prev(nullptr) {}
+        list_hook& operator=(const list_hook&) { return *this; }
+
+        bool is_linked() const { return next != nullptr; }
+    };
+
+    //由hook的地址得到所在对象的地址
+    template <typename T, list_hook T::*Hook>
+    struct hook_traits{
+        static ptrdiff_t offset() {
+            //只取成员地址，不访问对象
+            const T* p = reinterpret_cast<const T*>(alignof(T));
+            return reinterpret_cast<const char*>(&(p->*Hook)) - reinterpret_cast<const char*>(p);
+        }
+        static T* to_value(list_hook* h) {
+            return reinterpret_cast<T*>(reinterpret_cast<char*>(h) - offset());
+        }
+        static list_hook* to_hook(T& value) { return &(value.*Hook); }
+    };
+
+    template <typename T, list_hook T::*Hook, typename Ref, typename Ptr>
+    struct intrusive_list_iterator{
+        using iterator_category = bidirectional_iterator_tag;
+        using value_type        = T;
+        using difference_type   = ptrdiff_t;
+        using reference         = Ref;
+        using pointer           = Ptr;
+        using self              = intrusive_list_iterator;
+
+        list_hook* node;
+
+        intrusive_list_iterator() : node(nullptr) {}
+        explicit intrusive_list_iterator(list_hook* h) : node(h) {}
+        //iterator可以转换为const_iterator
+        template <typename R, typename P>
+        intrusive_list_iterator(const intrusive_list_iterator<T, Hook, R, P>& it) : node(it.node) {}
+
+        reference operator*() const { return *hook_traits<T, Hook>::to_value(node); }
+        pointer operator->() const { return hook_traits<T, Hook>::to_value(node); }
+
+        self& operator++() { node = node->next; return *this; }
+        self operator++(int) { self tmp = *this; node = node->next; return tmp; }
+        self& operator--() { node = node->prev; return *this; }
+        self operator--(int) { self tmp = *this; node = node->prev; return tmp; }
+
+        bool operator==(const self& rhs) const { return node == rhs.node; }
+        bool operator!=(const self& rhs) const { return node != rhs.node; }
+    };
+
+    //用法：struct timer { list_hook hook; ... };  intrusive_list<timer, &timer::hook> timers;
+    template <typename T, list_hook T::*Hook>
+    class intrusive_list{
+    public:
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using iterator = intrusive_list_iterator<T, Hook, T&, T*>;
+        using const_iterator = intrusive_list_iterator<T, Hook, const T&, const T*>;
+        using reverse_iter = reverse_iterator<iterator>;
+        using const_reverse_iter = reverse_iterator<const_iterator>;
+
+    protected:
+        using traits = hook_traits<T, Hook>;
+        //哨兵hook直接作为成员，空链表也不需要分配内存
+        list_hook head;
+        size_type len;
+
+        //摘下h，并把它标记为不在链表中
+        static void unlink(list_hook* h) {
+            h->prev->next = h->next;
+            h->next->prev = h->prev;
+            h->next = nullptr;
+            h->prev = nullptr;
+        }
+
+    public:
+        /*构造与析构*/
+        intrusive_list() : len(0) { head.next = head.prev = &head; }
+        //对象不能同时在两个链表中，所以不能拷贝，只能移动
+        intrusive_list(const intrusive_list&) = delete;
+        intrusive_list& operator=(const intrusive_list&) = delete;
+        intrusive_list(intrusive_list&& rhs) : len(0) {
+            head.next = head.prev = &head;
+            splice(end(), rhs);
+        }
+        intrusive_list& operator=(intrusive_list&& rhs) {
+            if (&rhs != this) {
+                clear();
+                splice(end(), rhs);
+            }
+            return *this;
+        }
+        //只摘下对象，不析构
+        ~intrusive_list() { clear(); }
+
+        //元素访问
+        reference front() { return *traits::to_value(head.next); }
+        const_reference front() const { return *traits::to_value(head.next); }
+        reference back() { return *traits::to_value(head.prev); }
+        const_reference back() const { return *traits::to_value(head.prev); }
+
+        //迭代器
+        iterator begin() { return iterator(head.next); }
+        iterator end() { return iterator(&head); }
+        const_iterator begin() const { return const_iterator(head.next); }
+        const_iterator end() const { return const_iterator(const_cast<list_hook*>(&head)); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+        reverse_iter rbegin() { return reverse_iter(end()); }
+        reverse_iter rend() { return reverse_iter(begin()); }
+        //由链表中的对象得到指向它的迭代器
+        iterator iterator_to(reference value) { return iterator(traits::to_hook(value)); }
+
+        //容量
+        size_type size() const { return len; }
+        bool empty() const { return len == 0; }
+
+        //修改器
+        //把value链接到pos之前，value不能已经在某个链表中
+        iterator insert(iterator pos, reference value) {
+            list_hook* h = traits::to_hook(value);
+            h->next = pos.node;
+            h->prev = pos.node->prev;
+            pos.node->prev->next = h;
+            pos.node->prev = h;
+            ++len;
+            return iterator(h);
+        }
+        //摘下pos处的对象，返回下一个位置
+        iterator erase(iterator pos) {
+            list_hook* next = pos.node->next;
+            unlink(pos.node);
+            --len;
+            return iterator(next);
+        }
+        iterator erase(iterator first, iterator last) {
+            while (first != last)
+                first = erase(first);
+            return last;
+        }
+        //已知对象时直接摘下，value必须在这个链表中
+        void erase(reference value) { erase(iterator_to(value)); }
+        void push_back(reference value) { insert(end(), value); }
+        void push_front(reference value) { insert(begin(), value); }
+        void pop_back() { erase(iterator(head.prev)); }
+        void pop_front() { erase(begin()); }
+        void clear() {
+            list_hook* h = head.next;
+            while (h != &head) {
+                list_hook* next = h->next;
+                h->next = nullptr;
+                h->prev = nullptr;
+                h = next;
+            }
+            head.next = head.prev = &head;
+            len = 0;
+        }
+        //哨兵在对象内部，不能直接交换指针，通过splice交换
+        void swap(intrusive_list& rhs) {
+            if (&rhs == this)
+                return;
+            intrusive_list temp;
+            temp.splice(temp.end(), rhs);
+            rhs.splice(rhs.end(), *this);
+            splice(end(), temp);
+        }
+
+        //操作
+        //转移other的全部对象到pos之前
+        void splice(iterator pos, intrusive_list& other) {
+            if (other.empty() || &other == this)
+                return;
+            link_transfer(pos.node, other.head.next, &other.head);
+            len += other.len;
+            other.len = 0;
+        }
+        //转移other中it处的对象到pos之前，LRU中把对象移到表头就是splice(begin(), *this, iterator_to(x))
+        void splice(iterator pos, intrusive_list& other, iterator it) {
+            list_hook* next = it.node->next;
+            if (pos.node == it.node || pos.node == next)
+                return;
+            link_transfer(pos.node, it.node, next);
+            ++len;
+            --other.len;
+        }
+        //转移other中[first, last)的对象到pos之前
+        void splice(iterator pos, intrusive_list& other, iterator first, iterator last) {
+            if (first == last)
+                return;
+            if (&other != this) {
+                const size_type n = (first == other.begin() && last == other.end())
+                                    ? other.len : size_type(MyStl::distance(first, last));
+                len += n;
+                other.len -= n;
+            }
+            link_transfer(pos.node, first.node, last.node);
+        }
+    };
+}
+
+#endif //MYSTL_INTRUSIVE_LIST_H
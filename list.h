@@ -5,19 +5,20 @@
 #include "iterator.h"
 #include "pool_allocator.h"
 #include "construct.h"
+#include "move.h"
 #include "initializer_list"
+#include <cstdlib>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
 namespace MyStl{
     //双向节点的封装
+    //节点只分配内存，data由create_node在原地构造，所以不要求T有默认构造函数
     template<typename T>
     struct list_node{
         list_node<T> *next;
         list_node<T> *prev;
         T data;
-
-        list_node(const T& value = T())
-        :data(value)
-        ,next(nullptr)
-        ,prev(nullptr){}
     };
 
     //迭代器封装，实现链表指针的自增自减，以及比较等操作
@@ -113,6 +114,21 @@ namespace MyStl{
         }
     };
 
+    //把[first, last)中的节点摘下，链接到pos之前，只修改指针
+    //节点只需要有next和prev成员，list和intrusive_list共用
+    template<typename NodePtr>
+    void link_transfer(NodePtr pos, NodePtr first, NodePtr last) {
+        if (pos != last){
+            last->prev->next = pos;
+            first->prev->next = last;
+            pos->prev->next = first;
+            NodePtr temp = pos->prev;
+            pos->prev = last->prev;
+            last->prev = first->prev;
+            first->prev = temp;
+        }
+    }
+
     template<typename T, typename Allocator = MyStl::pool_alloc<list_node<T>>>
     class list{
     protected:
@@ -134,6 +150,8 @@ namespace MyStl{
         using node_pointer = link_node*;
     protected:
         node_pointer node;
+        //元素个数，insert/erase/splice/swap时维护，size()不需要遍历链表
+        size_type len;
         //内部函数
         /*
          * 分配、释放、构造、析构一个节点内存及对象并返回
@@ -142,8 +160,9 @@ namespace MyStl{
         node_pointer get_node() {return Allocator::allocate(); }
         //释放, 将这块内存重新放回内存池中对应链表的表头
         void put_node(node_pointer p) { Allocator::deallocate(p);}
-        //构造和析构
-        node_pointer create_node(const value_type& value);
+        //构造和析构，用args在节点中直接构造元素
+        template <typename... Args>
+        node_pointer create_node(Args&&... args);
         void destroy_node(node_pointer p);
         //创建一个空链表
         void empty_initialize();
@@ -154,6 +173,29 @@ namespace MyStl{
         void copy_initialize(InputIterator first, InputIterator last);
         //Moves the elements from [first,last) before pos
         void transfer(iterator pos, iterator first, iterator last);
+        //批量插入时先把新节点链接成一条私有的链，链头的prev和链尾的next不设值
+        //全部构造成功后由link_chain一次接到pos之前；构造失败时由destroy_chain释放，原链表不变
+        iterator link_chain(iterator pos, node_pointer head, node_pointer tail, size_type n);
+        void destroy_chain(node_pointer head, node_pointer tail);
+        //按buf中的顺序重新链接全部n个节点，node_of从数组元素中取出节点指针
+        template <typename Entry, typename NodeOf>
+        void relink(const Entry* buf, size_type n, NodeOf node_of);
+        //把节点指针收集到连续的数组中排序再重新链接，数组分配失败时返回false
+        //算术类型把值和节点指针一起拷贝到数组中，比较时不需要访问分散的节点
+        template <typename Compare>
+        bool buffer_sort(Compare comp, std::true_type);
+        template <typename Compare>
+        bool buffer_sort(Compare comp, std::false_type);
+        //原来的归并排序，不需要额外分配内存
+        template <typename Compare>
+        void merge_sort(Compare comp);
+        //不带比较器的版本使用的默认比较
+        struct value_less{
+            bool operator()(const T& a, const T& b) const { return a < b; }
+        };
+        struct value_equal{
+            bool operator()(const T& a, const T& b) const { return a == b; }
+        };
     public:
         //成员函数
         //构造与析构函数
@@ -168,6 +210,11 @@ namespace MyStl{
         //拷贝构造构造必须是深拷贝
         list(const list<T,Allocator>& rhs){ copy_initialize(rhs.begin(), rhs.end()); }
         list(std::initializer_list<value_type> rhs) { copy_initialize(rhs.begin(), rhs.end());}
+        //移动构造直接接管rhs的哨兵节点，rhs换上一个新的空哨兵
+        list(list&& rhs) {
+            empty_initialize();
+            swap(rhs);
+        }
 
         ~list(){
             clear();
@@ -176,6 +223,13 @@ namespace MyStl{
 
         list<T, Allocator>& operator=(const list<T, Allocator>& rhs);
         list<T, Allocator>& operator=(std::initializer_list<T> rhs);
+        list<T, Allocator>& operator=(list&& rhs) {
+            if (&rhs != this) {
+                clear();
+                swap(rhs);
+            }
+            return *this;
+        }
 
         //元素访问
         reference front() { return node->next->data; }
@@ -202,29 +256,46 @@ namespace MyStl{
 
         //容量
         bool empty() const noexcept{return node->next == node;}
-        size_type size() const noexcept{ return distance(begin(),end());}
+        size_type size() const noexcept{ return len;}
         size_type max_size() const noexcept{ return Allocator::max_size();}
 
         //修改器
         void clear() { erase(begin(),end());}
-        iterator insert(iterator pos, const value_type& value);
+        iterator insert(iterator pos, const value_type& value) { return emplace(pos, value); }
+        iterator insert(iterator pos, value_type&& value) { return emplace(pos, MyStl::move(value)); }
         iterator insert(iterator pos, size_type n, const value_type& value);
-        void insert(iterator pos, int n, const T& value){ insert(pos, size_type(n), value);}
-        void insert(iterator pos, long n, const T& value){ insert(pos, size_type(n), value);}
+        iterator insert(iterator pos, int n, const T& value){ return insert(pos, size_type(n), value);}
+        iterator insert(iterator pos, long n, const T& value){ return insert(pos, size_type(n), value);}
         template<typename InputIterator>
-        void insert(iterator pos, InputIterator first, InputIterator last);
+        iterator insert(iterator pos, InputIterator first, InputIterator last);
         iterator erase(iterator pos);
         iterator erase(iterator first, iterator last);
         void pop_back() { erase(--end());}
         void pop_front() { erase(begin());}
-        void push_back(const value_type& value) { insert(end(),value);}
-        void push_front(const value_type& value) { insert(begin(),value);}
+        void push_back(const value_type& value) { emplace(end(), value);}
+        void push_back(value_type&& value) { emplace(end(), MyStl::move(value));}
+        void push_front(const value_type& value) { emplace(begin(), value);}
+        void push_front(value_type&& value) { emplace(begin(), MyStl::move(value));}
+        //在pos之前用args直接构造元素，不产生临时对象
+        template <typename... Args>
+        iterator emplace(iterator pos, Args&&... args);
+        template <typename... Args>
+        void emplace_back(Args&&... args) { emplace(end(), MyStl::forward<Args>(args)...); }
+        template <typename... Args>
+        void emplace_front(Args&&... args) { emplace(begin(), MyStl::forward<Args>(args)...); }
         void resize(size_type new_size, const T& value = T());
-        void swap(list<T, Allocator>& rhs) { std::swap(node, rhs.node); }
+        void swap(list<T, Allocator>& rhs) {
+            std::swap(node, rhs.node);
+            std::swap(len, rhs.len);
+        }
 
         //操作
         //merge 将other合并到this身上，前提是两个list已经递增排序好了
-        void merge(list& other);
+        //相等的元素中this的在前，other的在后
+        void merge(list& other) { merge(other, value_less()); }
+        //两个list都已经按comp排序好了
+        template <typename Compare>
+        void merge(list& other, Compare comp);
         //从一个 list 转移元素给另一个.不复制或移动元素，仅重指向链表结点的内部指针。
         //所以要用到transfer函数
         // 从 other 转移所有元素到 *this 中。
@@ -235,30 +306,38 @@ namespace MyStl{
         void splice(iterator pos, list& other , iterator first, iterator last);
         //移除所有满足特定标准的元素。第一版本移除所有等于 value 的元素
         void remove(const T& value );
+        //第二版本移除所有pred返回true的元素
+        template <typename Predicate>
+        void remove_if(Predicate pred);
         //逆转容器中的元素顺序。不非法化任何引用或迭代器。
         void reverse() noexcept;
         //从容器移除所有相继的重复元素。只留下相等元素组中的第一个元素。若选择的比较器不建立等价关系则行为未定义。
-        void unique();
+        void unique() { unique(value_equal()); }
+        //用pred(前一个保留的元素, 当前元素)判断是否重复
+        template <typename BinaryPredicate>
+        void unique(BinaryPredicate pred);
         //以升序排序元素。保持相等元素的顺序。第一版本用 operator< 比较元素
-        //list不能使用STL的排序算法，因为STL的sort只接受随机迭代器
-        void sort();
+        //list不能直接使用STL的排序算法，因为STL的sort只接受随机迭代器
+        //先把节点收集到数组中用std::stable_sort排序，数组分配失败时退回归并排序
+        void sort() { sort(value_less()); }
+        //第二版本用comp比较元素，比较器按值传入，可以内联
+        template <typename Compare>
+        void sort(Compare comp);
 
     };
 
     template<typename T, typename Allocator>
     list<T, Allocator> &list<T, Allocator>::operator=(std::initializer_list<T> rhs) {
-        if (&rhs != this) {
-            iterator first1 = begin();
-            iterator last1 = end();
-            const_iterator first2 = rhs.cbegin();
-            const_iterator last2 = rhs.cend();
-            for (; first1 != last1 && first2 != last2; ++first1, ++first1)
-                *first1 = *first2;
-            if (first1 == last1)
-                insert(last1, first2, last2);
-            else
-                erase(first1, last1);
-        }
+        iterator first1 = begin();
+        iterator last1 = end();
+        auto first2 = rhs.begin();
+        auto last2 = rhs.end();
+        for (; first1 != last1 && first2 != last2; ++first1, ++first2)
+            *first1 = *first2;
+        if (first1 == last1)
+            insert(last1, first2, last2);
+        else
+            erase(first1, last1);
         return *this;
     }
 
@@ -271,7 +350,7 @@ namespace MyStl{
             iterator last1 = end();
             const_iterator first2 = rhs.cbegin();
             const_iterator last2 = rhs.cend();
-            for (; first1 != last1 && first2 != last2; ++first1, ++first1)
+            for (; first1 != last1 && first2 != last2; ++first1, ++first2)
                 *first1 = *first2;
             if (first1 == last1)
                 insert(last1, first2, last2);
@@ -288,8 +367,9 @@ namespace MyStl{
         try {
             insert(begin(), first, last);
         } catch (...) {
-            clear();
+            //insert失败时没有插入任何节点，只需释放哨兵
             put_node(node);
+            throw;
         }
     }
 
@@ -299,16 +379,83 @@ namespace MyStl{
         try {
             insert(begin(), n, value);
         } catch (...){
-            clear();
             put_node(node);
+            throw;
         }
     }
 
     template<typename T, typename Allocator>
-    void list<T, Allocator>::sort() {
+    template<typename Compare>
+    void list<T, Allocator>::sort(Compare comp) {
         //链表空或者只有一个节点则不需要比较
         if (node->next == node || node->next->next == node)
             return;
+        if (!buffer_sort(comp, std::integral_constant<bool, std::is_arithmetic<T>::value>()))
+            merge_sort(comp);
+    }
+
+    template<typename T, typename Allocator>
+    template<typename Entry, typename NodeOf>
+    void list<T, Allocator>::relink(const Entry* buf, size_type n, NodeOf node_of) {
+        node_pointer prev = node;
+        for (size_type i = 0; i < n; ++i) {
+            node_pointer cur = node_of(buf[i]);
+            prev->next = cur;
+            cur->prev = prev;
+            prev = cur;
+        }
+        prev->next = node;
+        node->prev = prev;
+    }
+
+    template<typename T, typename Allocator>
+    template<typename Compare>
+    bool list<T, Allocator>::buffer_sort(Compare comp, std::true_type) {
+        using entry = std::pair<T, node_pointer>;
+        const size_type n = len;
+        entry* buf = static_cast<entry*>(std::malloc(n * sizeof(entry)));
+        if (!buf)
+            return false;
+        node_pointer cur = node->next;
+        //malloc返回的内存上还没有对象，在原地构造；entry可平凡析构，释放前不需要析构
+        for (size_type i = 0; i < n; ++i, cur = cur->next)
+            MyStl::construct(buf + i, cur->data, cur);
+        try {
+            std::stable_sort(buf, buf + n, [&comp](const entry& a, const entry& b) { return comp(a.first, b.first); });
+        } catch (...) {
+            std::free(buf);
+            throw;
+        }
+        relink(buf, n, [](const entry& e) { return e.second; });
+        std::free(buf);
+        return true;
+    }
+
+    template<typename T, typename Allocator>
+    template<typename Compare>
+    bool list<T, Allocator>::buffer_sort(Compare comp, std::false_type) {
+        const size_type n = len;
+        node_pointer* buf = static_cast<node_pointer*>(std::malloc(n * sizeof(node_pointer)));
+        if (!buf)
+            return false;
+        node_pointer cur = node->next;
+        for (size_type i = 0; i < n; ++i, cur = cur->next)
+            buf[i] = cur;
+        try {
+            std::stable_sort(buf, buf + n, [&comp](node_pointer a, node_pointer b) { return comp(a->data, b->data); });
+        } catch (...) {
+            //比较抛出异常时链表还没有改动
+            std::free(buf);
+            throw;
+        }
+        relink(buf, n, [](node_pointer p) { return p; });
+        std::free(buf);
+        return true;
+    }
+
+    template<typename T, typename Allocator>
+    template<typename Compare>
+    void list<T, Allocator>::merge_sort(Compare comp) {
         list carry;
         //使用一个数组来保存排序后的链表，数组大小64，也就是最多可以排序2^63长度的链表
         list tmp[64];
@@ -320,7 +467,7 @@ namespace MyStl{
             carry.splice(carry.begin(),*this, begin());
             counter = tmp;
             while (counter != fill && !counter->empty()){
-                counter->merge(carry);
+                counter->merge(carry, comp);
                 carry.swap(*counter);
                 ++counter;
             }
@@ -330,21 +477,24 @@ namespace MyStl{
                 ++fill;
         }
         for (counter = tmp + 1; counter != fill ; ++counter) {
-            counter->merge(*(counter-1));
+            counter->merge(*(counter-1), comp);
         }
         swap(*(fill - 1));
     }
 
     template<typename T, typename Allocator>
-    void list<T, Allocator>::unique() {
+    template<typename BinaryPredicate>
+    void list<T, Allocator>::unique(BinaryPredicate pred) {
         if (empty())
             return;
         iterator first = begin();
         iterator last = end();
         iterator next = first;
         while (++next != last){
-            if (*first == *next){
-                first = erase(first);
+            //保留相等元素组中的第一个，删除后面的
+            if (pred(*first, *next)){
+                erase(next);
+                next = first;
             } else{
                 first = next;
             }
@@ -369,18 +519,33 @@ namespace MyStl{
     void list<T, Allocator>::remove(const T &value) {
         iterator first = begin();
         iterator last = end();
+        //value可能就是链表中的元素，这个节点最后再删除
+        iterator self = last;
         while (first != last){
-            if (*first == value)
-                erase(first++);
+            if (*first == value) {
+                if (&*first != &value)
+                    erase(first++);
+                else
+                    self = first++;
+            } else
+                ++first;
         }
+        if (self != last)
+            erase(self);
     }
 
     template<typename T, typename Allocator>
     void list<T, Allocator>::splice(list::iterator pos, list &other, list::iterator first, list::iterator last) {
         if (first == last)
             return;
+        //同一个链表内部移动不改变个数；整个other转移时个数已知，否则才需要数一遍
+        if (&other != this) {
+            const size_type n = (first == other.begin() && last == other.end())
+                                ? other.len : size_type(distance(first, last));
+            len += n;
+            other.len -= n;
+        }
         transfer(pos, first, last);
-
     }
 
     template<typename T, typename Allocator>
@@ -390,25 +555,43 @@ namespace MyStl{
         if (pos == its || pos == it)
             return;
         transfer(pos, it, its);
+        ++len;
+        --other.len;
     }
 
     template<typename T, typename Allocator>
     void list<T, Allocator>::splice(list::iterator pos, list &other) {
-        if (other.empty())
+        if (other.empty() || &other == this)
             return;
         transfer(pos, other.begin(), other.end());
+        len += other.len;
+        other.len = 0;
+    }
+
+    template<typename T, typename Allocator>
+    template<typename Predicate>
+    void list<T, Allocator>::remove_if(Predicate pred) {
+        iterator first = begin();
+        iterator last = end();
+        while (first != last){
+            if (pred(*first))
+                first = erase(first);
+            else
+                ++first;
+        }
     }
 
     template<typename T, typename Allocator>
-    void list<T, Allocator>::merge(list &other) {
-        if (other.empty())
+    template<typename Compare>
+    void list<T, Allocator>::merge(list &other, Compare comp) {
+        if (other.empty() || &other == this)
             return;
         iterator first1 = begin();
         iterator last1 = end();
         iterator first2 = other.begin();
         iterator last2 = other.end();
         while (first1 != last1 && first2 != last2){
-            if (*first2 < *first1){
+            if (comp(*first2, *first1)){
                 splice(first1, other, first2);
                 first2 = other.begin();
             } else
@@ -445,43 +628,90 @@ namespace MyStl{
         pos.node->prev->next = temp.node;
         temp.node->prev = pos.node->prev;
         destroy_node(pos.node);
+        --len;
         return temp;
     }
 
+    //节点在私有链上构造，构造过程中不修改原链表，[first, last)可以是本链表中的区间
     template<typename T, typename Allocator>
     template<typename InputIterator>
-    void list<T, Allocator>::insert(list::iterator pos, InputIterator first, InputIterator last) {
-        for (; first != last; ++first)
-            insert(pos, *first);
+    typename list<T, Allocator>::iterator list<T, Allocator>::insert(list::iterator pos, InputIterator first, InputIterator last) {
+        if (first == last)
+            return pos;
+        node_pointer head = create_node(*first);
+        node_pointer tail = head;
+        size_type n = 1;
+        try {
+            for (++first; first != last; ++first, ++n) {
+                node_pointer p = create_node(*first);
+                tail->next = p;
+                p->prev = tail;
+                tail = p;
+            }
+        } catch (...) {
+            destroy_chain(head, tail);
+            throw;
+        }
+        return link_chain(pos, head, tail, n);
     }
 
     template<typename T, typename Allocator>
     typename list<T, Allocator>::iterator list<T, Allocator>::insert(list::iterator pos, list::size_type n, const value_type &value) {
-        for (; n > 0; --n) {
-            insert(pos,value);
+        if (n == 0)
+            return pos;
+        node_pointer head = create_node(value);
+        node_pointer tail = head;
+        try {
+            for (size_type i = 1; i < n; ++i) {
+                node_pointer p = create_node(value);
+                tail->next = p;
+                p->prev = tail;
+                tail = p;
+            }
+        } catch (...) {
+            destroy_chain(head, tail);
+            throw;
+        }
+        return link_chain(pos, head, tail, n);
+    }
+
+    //只修改pos前后的四个指针，返回第一个新节点
+    template<typename T, typename Allocator>
+    typename list<T, Allocator>::iterator list<T, Allocator>::link_chain(list::iterator pos, node_pointer head, node_pointer tail, list::size_type n) {
+        head->prev = pos.node->prev;
+        tail->next = pos.node;
+        pos.node->prev->next = head;
+        pos.node->prev = tail;
+        len += n;
+        return head;
+    }
+
+    template<typename T, typename Allocator>
+    void list<T, Allocator>::destroy_chain(node_pointer head, node_pointer tail) {
+        //tail的next没有设值，不能读取
+        while (head != tail) {
+            node_pointer next = head->next;
+            destroy_node(head);
+            head = next;
         }
+        destroy_node(tail);
     }
 
     template<typename T, typename Allocator>
-    typename list<T, Allocator>::iterator list<T, Allocator>::insert(list::iterator pos, const value_type &value) {
-        auto temp = create_node(value);
+    template<typename... Args>
+    typename list<T, Allocator>::iterator list<T, Allocator>::emplace(list::iterator pos, Args&&... args) {
+        auto temp = create_node(MyStl::forward<Args>(args)...);
         pos.node->prev->next = temp;
         temp->prev = pos.node->prev;
         temp->next = pos.node;
         pos.node->prev = temp;
+        ++len;
+        return temp;
     }
 
     template<typename T, typename Allocator>
     void list<T, Allocator>::transfer(list::iterator pos, list::iterator first, list::iterator last) {
-        if (pos != last){
-            last.node->prev->next = pos.node;
-            first.node->prev->next = last.node;
-            pos.node->prev->next = first.node;
-            node_pointer temp = pos.node->prev;
-            pos.node->prev = last.node->prev;
-            last.node->prev = first.node->prev;
-            first.node->prev = temp;
-        }
+        link_transfer(pos.node, first.node, last.node);
     }
 
 
@@ -490,6 +720,7 @@ namespace MyStl{
         node = get_node();
         node->next = node;
         node->prev = node;
+        len = 0;
     }
 
     template<typename T, typename Allocator>
@@ -498,14 +729,16 @@ namespace MyStl{
         put_node(p);
     }
 
-    //先分配内存，再构造
+    //先分配内存，再在data上原地构造
     template<typename T, typename Allocator>
-    typename list<T, Allocator>::node_pointer list<T, Allocator>::create_node(const value_type &value) {
+    template<typename... Args>
+    typename list<T, Allocator>::node_pointer list<T, Allocator>::create_node(Args&&... args) {
         auto p = get_node();
         try {
-            construct(&p->data, value);
+            MyStl::construct(&p->data, MyStl::forward<Args>(args)...);
         } catch (...) {
             put_node(p);
+            throw;
         }
         return p;
     }
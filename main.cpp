@@ -8,8 +8,35 @@
 #include "test_stack.h"
 #include "test_queue.h"
 #include "test_priority_queue.h"
+#include "test_soa_vector.h"
+#include "test_mmap_vector.h"
+#include "test_persistent_vector.h"
+#include "test_dynamic_bitset.h"
+#include "test_ring_deque.h"
+#include "test_spsc_queue.h"
+#include "test_mpmc_queue.h"
+#include "test_unrolled_list.h"
+#include "test_intrusive_list.h"
+#include "test_compact_list.h"
+#include "test_skip_list.h"
 using namespace std;
 int main(){
+    MyStl::test_vector();
+    MyStl::test_list();
+    MyStl::test_deque();
+    MyStl::test_stack();
+    MyStl::test_queue();
     MyStl::test_priority_queue();
+    MyStl::test_soa_vector();
+    MyStl::test_mmap_vector();
+    MyStl::test_persistent_vector();
+    MyStl::test_dynamic_bitset();
+    MyStl::test_ring_deque();
+    MyStl::test_spsc_queue();
+    MyStl::test_mpmc_queue();
+    MyStl::test_unrolled_list();
+    MyStl::test_intrusive_list();
+    MyStl::test_compact_list();
+    MyStl::test_skip_list();
 
-}
\ No newline at end of file
+}
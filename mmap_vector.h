@@ -0,0 +1,228 @@
+
+#ifndef MYSTL_MMAP_VECTOR_H
+#define MYSTL_MMAP_VECTOR_H
+
+//元素存放在内存映射文件中的vector，只支持可平凡拷贝的类型
+//文件 = 64字节的文件头 + 连续的元素区；size也保存在文件头中，所以重新打开文件就能得到原来的内容
+//启动时只需要建立映射，不需要解析数据，多个进程映射同一个文件时还能共享操作系统的页缓存
+//扩容使用ftruncate扩大文件，再使用mremap扩大映射(非Linux系统退化为munmap + mmap)
+#include <type_traits>
+#include <system_error>
+#include <stdexcept>
+#include <cerrno>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "iterator.h"
+
+namespace MyStl{
+    template <typename T>
+    class mmap_vector{
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "mmap_vector only supports trivially copyable types");
+    public:
+        using value_type        = T;
+        using pointer           = T*;
+        using const_pointer     = const T*;
+        using iterator          = T*;
+        using const_iterator    = const T*;
+        using reference         = T&;
+        using const_reference   = const T&;
+        using size_type         = size_t;
+        using difference_type   = ptrdiff_t;
+
+        using reverse_iter       = reverse_iterator<iterator>;
+        using const_reverse_iter = reverse_iterator<const_iterator>;
+
+    protected:
+        //文件头，大小固定为header_bytes，元素区从header_bytes处开始
+        struct file_header{
+            uint64_t magic;
+            uint64_t elem_size;
+            uint64_t size;
+            uint64_t capacity;
+        };
+        enum : uint64_t { magic_number = 0x4D59535456454331ULL };   //"MYSTVEC1"
+        enum { header_bytes = 64 };
+        static_assert(alignof(T) <= header_bytes, "element alignment is too large");
+
+        int fd;
+        char* base;         //映射区首地址
+        size_t map_bytes;   //映射区大小，与文件大小一致
+
+        file_header* header() const { return reinterpret_cast<file_header*>(base); }
+        T* start() const { return reinterpret_cast<T*>(base + header_bytes); }
+        static size_t bytes_for(size_type cap) { return header_bytes + cap * sizeof(T); }
+
+        static void throw_errno(const char* what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+        //打开文件并建立映射，新文件写入文件头
+        void open(const char* path, size_type init_cap);
+        //扩大文件和映射，使其能容纳new_cap个元素
+        void remap(size_type new_cap);
+        void unmap();
+        //与vector相同的增长策略
+        size_type next_capacity() const { return size() == 0 ? 10 : 2 * size(); }
+
+    public:
+        //打开或创建path，已存在的文件会在原地重新映射
+        explicit mmap_vector(const char* path, size_type init_cap = 0) : fd(-1), base(nullptr), map_bytes(0) {
+            open(path, init_cap);
+            try {
+                reserve(init_cap);
+            } catch (...) {
+                unmap();
+                throw;
+            }
+        }
+        mmap_vector(const mmap_vector&) = delete;
+        mmap_vector& operator=(const mmap_vector&) = delete;
+        ~mmap_vector() { unmap(); }
+
+        //元素访问
+        reference front() { return *begin(); }
+        const_reference front() const { return *begin(); }
+        reference back() { return *(end() - 1); }
+        const_reference back() const { return *(end() - 1); }
+        reference operator[](size_type pos) { return start()[pos]; }
+        const_reference operator[](size_type pos) const { return start()[pos]; }
+        reference at(size_type n) {
+            if (n >= size())
+                throw std::out_of_range("mmap_vector::at");
+            return (*this)[n];
+        }
+        const_reference at(size_type n) const {
+            if (n >= size())
+                throw std::out_of_range("mmap_vector::at");
+            return (*this)[n];
+        }
+        T* data() { return start(); }
+        const T* data() const { return start(); }
+
+        //迭代器，映射可能在扩容时移动，所以扩容后迭代器失效
+        iterator begin() noexcept { return start(); }
+        const_iterator begin() const noexcept { return start(); }
+        iterator end() noexcept { return start() + size(); }
+        const_iterator end() const noexcept { return start() + size(); }
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+        reverse_iter rbegin() noexcept { return reverse_iter(end()); }
+        const_reverse_iter rbegin() const noexcept { return const_reverse_iter(end()); }
+        reverse_iter rend() noexcept { return reverse_iter(begin()); }
+        const_reverse_iter rend() const noexcept { return const_reverse_iter(begin()); }
+
+        //容量
+        size_type size() const { return header()->size; }
+        size_type capacity() const { return header()->capacity; }
+        bool empty() const { return size() == 0; }
+        size_type max_size() const { return size_type(-1) / sizeof(value_type); }
+        void reserve(size_type new_cap) {
+            if (new_cap > capacity())
+                remap(new_cap);
+        }
+
+        //修改器，元素可平凡拷贝，所以直接赋值即可
+        //value可能是本容器中的元素，remap可能移动映射区，所以先拷贝一份
+        void push_back(const T& value) {
+            const T tmp = value;
+            if (size() == capacity())
+                remap(next_capacity());
+            start()[size()] = tmp;
+            ++header()->size;
+        }
+        void pop_back() { --header()->size; }
+        void resize(size_type count, const value_type& value = T()) {
+            const T tmp = value;
+            reserve(count);
+            for (size_type i = size(); i < count; ++i)
+                start()[i] = tmp;
+            header()->size = count;
+        }
+        void clear() { header()->size = 0; }
+
+        //把修改同步写回文件
+        void flush() {
+            if (msync(base, map_bytes, MS_SYNC) != 0)
+                throw_errno("mmap_vector: msync");
+        }
+    };
+
+    template <typename T>
+    void mmap_vector<T>::open(const char* path, size_type init_cap) {
+        fd = ::open(path, O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+            throw_errno("mmap_vector: open");
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw_errno("mmap_vector: fstat");
+        }
+        try {
+            if (st.st_size == 0) {
+                //新文件：先扩大文件，然后写文件头
+                map_bytes = bytes_for(init_cap);
+                if (ftruncate(fd, map_bytes) != 0)
+                    throw_errno("mmap_vector: ftruncate");
+            } else {
+                map_bytes = st.st_size;
+                if (map_bytes < size_t(header_bytes))
+                    throw std::runtime_error("mmap_vector: file is too small");
+            }
+            void* p = mmap(nullptr, map_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED)
+                throw_errno("mmap_vector: mmap");
+            base = static_cast<char*>(p);
+            if (st.st_size == 0) {
+                header()->magic = magic_number;
+                header()->elem_size = sizeof(T);
+                header()->size = 0;
+                header()->capacity = init_cap;
+            } else if (header()->magic != magic_number || header()->elem_size != sizeof(T)
+                       || header()->capacity > (map_bytes - header_bytes) / sizeof(T)) {
+                throw std::runtime_error("mmap_vector: file does not match element type");
+            } else if (header()->size > header()->capacity) {
+                //size损坏时begin()/end()会越过映射区
+                throw std::runtime_error("mmap_vector: corrupt size in header");
+            }
+        } catch (...) {
+            unmap();
+            throw;
+        }
+    }
+
+    template <typename T>
+    void mmap_vector<T>::remap(size_type new_cap) {
+        size_t new_bytes = bytes_for(new_cap);
+        if (ftruncate(fd, new_bytes) != 0)
+            throw_errno("mmap_vector: ftruncate");
+#ifdef __linux__
+        void* p = mremap(base, map_bytes, new_bytes, MREMAP_MAYMOVE);
+        if (p == MAP_FAILED)
+            throw_errno("mmap_vector: mremap");
+#else
+        void* p = mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED)
+            throw_errno("mmap_vector: mmap");
+        munmap(base, map_bytes);
+#endif
+        base = static_cast<char*>(p);
+        map_bytes = new_bytes;
+        header()->capacity = new_cap;
+    }
+
+    template <typename T>
+    void mmap_vector<T>::unmap() {
+        if (base)
+            munmap(base, map_bytes);
+        if (fd >= 0)
+            ::close(fd);
+        base = nullptr;
+        map_bytes = 0;
+        fd = -1;
+    }
+}
+
+#endif //MYSTL_MMAP_VECTOR_H
@@ -16,5 +16,10 @@ namespace MyStl{
         // 将右值作为右值转发
         return (static_cast<T&&>(arg));
     }
+    //无条件转换为右值，使对象的资源可以被移走
+    template<class T>
+    constexpr remove_reference_t<T>&& move(T&& arg) noexcept{
+        return static_cast<remove_reference_t<T>&&>(arg);
+    }
 }
 #endif //MYSTL_MOVE_H
@@ -0,0 +1,313 @@
+
+#ifndef MYSTL_MPMC_QUEUE_H
+#define MYSTL_MPMC_QUEUE_H
+
+//多生产者多消费者的有界无锁队列(Vyukov算法)，容量固定为2的幂
+//每个槽位带一个序号seq：seq == pos表示第pos次写入可以使用该槽位，seq == pos + 1表示第pos次写入已完成可以读取
+//生产者和消费者分别通过CAS推进enqueue_pos和dequeue_pos来占用槽位，不需要互斥锁
+//try_push_n/try_pop_n一次CAS占用连续的多个槽位，适合每个线程先在本地攒一批再提交
+//阻塞的push/pop先自旋重试，仍然失败时在futex上睡眠，对方完成操作后再唤醒
+//槽位一旦被占用就必须完成写入或读取，否则后面的槽位永远不会被发布，所以写入时的构造和读取时的移动赋值不能抛出异常
+//这一点由static_assert检查；拷贝可能抛出异常的类型(例如std::string)可以用右值push或move_iterator移动进队列
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <climits>
+#include <type_traits>
+#include <iterator>
+#include <new>
+#include "pool_allocator.h"
+#include "construct.h"
+#include "move.h"
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+namespace MyStl{
+    //word的值仍为expected时睡眠，直到被futex_wake唤醒
+    inline void futex_wait(std::atomic<uint32_t>* word, uint32_t expected) {
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+        if (word->load(std::memory_order_acquire) == expected)
+            std::this_thread::yield();
+#endif
+    }
+
+    //唤醒最多n个在word上睡眠的线程
+    inline void futex_wake(std::atomic<uint32_t>* word, int n) {
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE_PRIVATE, n, nullptr, nullptr, 0);
+#else
+        (void)word;
+        (void)n;
+#endif
+    }
+
+    inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+
+    template <typename T>
+    class mpmc_queue{
+    public:
+        using value_type = T;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = size_t;
+
+    protected:
+        struct cell{
+            std::atomic<size_type> seq;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+            T* ptr() { return reinterpret_cast<T*>(&storage); }
+        };
+        using cell_alloc = pool_alloc<cell>;
+        enum { cache_line = 64 };
+        //阻塞操作睡眠前自旋和让出时间片的次数
+        enum { spin_limit = 128, yield_limit = 16 };
+
+        //只读部分
+        cell* cells;
+        size_type cap;
+        size_type mask;
+        char pad0[cache_line];
+        std::atomic<size_type> enqueue_pos;
+        char pad1[cache_line];
+        std::atomic<size_type> dequeue_pos;
+        char pad2[cache_line];
+        //睡眠用的futex字和睡眠的线程数，not_empty由生产者推进，not_full由消费者推进
+        std::atomic<uint32_t> not_empty;
+        std::atomic<uint32_t> pop_waiters;
+        char pad3[cache_line];
+        std::atomic<uint32_t> not_full;
+        std::atomic<uint32_t> push_waiters;
+        char pad4[cache_line];
+
+        static size_type round_up(size_type n) {
+            size_type r = 2;
+            while (r < n)
+                r <<= 1;
+            return r;
+        }
+        static bool before(size_type a, size_type b) {
+            return static_cast<typename std::make_signed<size_type>::type>(a - b) < 0;
+        }
+
+        //占用最多n个连续的槽位，返回起始位置和个数，没有可用槽位时返回0
+        size_type claim_push(size_type n, size_type& pos);
+        size_type claim_pop(size_type n, size_type& pos);
+        //有线程在futex上睡眠时唤醒最多n个
+        //fence保证前面发布槽位的store先于读取waiters，与睡眠方先登记waiters再重试的顺序配对，不会丢失唤醒
+        static void notify(std::atomic<uint32_t>& word, std::atomic<uint32_t>& waiters, size_type n) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters.load(std::memory_order_relaxed)) {
+                word.fetch_add(1, std::memory_order_release);
+                futex_wake(&word, n > INT_MAX ? INT_MAX : int(n));
+            }
+        }
+        //op()成功前先自旋，再在word上睡眠
+        template <typename Op>
+        static void wait_until(Op op, std::atomic<uint32_t>& word, std::atomic<uint32_t>& waiters);
+
+    public:
+        //容量会向上取整到2的幂，至少为2
+        explicit mpmc_queue(size_type capacity)
+                : cells(nullptr), cap(round_up(capacity)), mask(cap - 1),
+                  enqueue_pos(0), dequeue_pos(0),
+                  not_empty(0), pop_waiters(0), not_full(0), push_waiters(0) {
+            cells = cell_alloc::allocate(cap);
+            //分配器只返回原始内存，先在每个槽位上构造atomic再使用
+            for (size_type i = 0; i < cap; ++i)
+                ::new (static_cast<void*>(&cells[i].seq)) std::atomic<size_type>(i);
+        }
+        mpmc_queue(const mpmc_queue&) = delete;
+        mpmc_queue& operator=(const mpmc_queue&) = delete;
+        //析构时不能再有其他线程访问队列
+        ~mpmc_queue() {
+            const size_type last = enqueue_pos.load(std::memory_order_relaxed);
+            for (size_type i = dequeue_pos.load(std::memory_order_relaxed); i != last; ++i)
+                MyStl::destroy(cells[i & mask].ptr());
+            cell_alloc::deallocate(cells, cap);
+        }
+
+        /*不阻塞的接口*/
+        bool try_push(const value_type& value) { return try_push_n(&value, 1) == 1; }
+        //队列满时value保持不变
+        bool try_push(value_type&& value) { return try_push_n(std::make_move_iterator(&value), 1) == 1; }
+        bool try_pop(value_type& value) { return try_pop_n(&value, 1) == 1; }
+        //从first开始最多写入n个元素，返回实际写入的个数
+        template <typename InputIterator>
+        size_type try_push_n(InputIterator first, size_type n);
+        //最多读取n个元素写入result，返回实际读取的个数
+        template <typename OutputIterator>
+        size_type try_pop_n(OutputIterator result, size_type n);
+
+        /*阻塞的接口*/
+        //队列满时等待
+        void push(const value_type& value) {
+            wait_until([&]() { return try_push(value); }, not_full, push_waiters);
+        }
+        void push(value_type&& value) {
+            wait_until([&]() { return try_push(MyStl::move(value)); }, not_full, push_waiters);
+        }
+        //队列空时等待
+        void pop(value_type& value) {
+            wait_until([&]() { return try_pop(value); }, not_empty, pop_waiters);
+        }
+        //写入全部n个元素，队列满时等待
+        template <typename ForwardIterator>
+        void push_n(ForwardIterator first, size_type n);
+        //读取至少一个、最多n个元素，返回实际读取的个数
+        template <typename OutputIterator>
+        size_type pop_n(OutputIterator result, size_type n) {
+            size_type got = 0;
+            if (n)
+                wait_until([&]() { return (got = try_pop_n(result, n)) != 0; }, not_empty, pop_waiters);
+            return got;
+        }
+
+        //其他线程同时修改时size只是近似值
+        size_type size() const {
+            const size_type h = dequeue_pos.load(std::memory_order_acquire);
+            const size_type t = enqueue_pos.load(std::memory_order_acquire);
+            return before(h, t) ? t - h : 0;
+        }
+        bool empty() const { return size() == 0; }
+        size_type capacity() const { return cap; }
+    };
+
+    template <typename T>
+    typename mpmc_queue<T>::size_type mpmc_queue<T>::claim_push(size_type n, size_type& pos) {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            //从pos开始数出连续空闲的槽位，它们只能被推进过enqueue_pos的生产者修改，CAS成功后就归自己所有
+            size_type k = 0;
+            size_type seq = 0;
+            for (; k < n && k < cap; ++k) {
+                seq = cells[(pos + k) & mask].seq.load(std::memory_order_acquire);
+                if (seq != pos + k)
+                    break;
+            }
+            if (k == 0) {
+                //槽位还没有被上一轮的消费者释放，队列已满
+                if (before(seq, pos))
+                    return 0;
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (enqueue_pos.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed))
+                return k;
+        }
+    }
+
+    template <typename T>
+    typename mpmc_queue<T>::size_type mpmc_queue<T>::claim_pop(size_type n, size_type& pos) {
+        pos = dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            size_type k = 0;
+            size_type seq = 0;
+            for (; k < n && k < cap; ++k) {
+                seq = cells[(pos + k) & mask].seq.load(std::memory_order_acquire);
+                if (seq != pos + k + 1)
+                    break;
+            }
+            if (k == 0) {
+                //槽位还没有被生产者写入，队列为空
+                if (before(seq, pos + 1))
+                    return 0;
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (dequeue_pos.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed))
+                return k;
+        }
+    }
+
+    template <typename T>
+    template <typename InputIterator>
+    typename mpmc_queue<T>::size_type mpmc_queue<T>::try_push_n(InputIterator first, size_type n) {
+        static_assert(std::is_nothrow_constructible<T, decltype(*first)>::value,
+                      "mpmc_queue: constructing an element from *first must not throw");
+        if (n == 0)
+            return 0;
+        size_type pos;
+        const size_type k = claim_push(n, pos);
+        for (size_type i = 0; i < k; ++i, ++first) {
+            cell& c = cells[(pos + i) & mask];
+            MyStl::construct(c.ptr(), *first);
+            c.seq.store(pos + i + 1, std::memory_order_release);
+        }
+        if (k)
+            notify(not_empty, pop_waiters, k);
+        return k;
+    }
+
+    template <typename T>
+    template <typename OutputIterator>
+    typename mpmc_queue<T>::size_type mpmc_queue<T>::try_pop_n(OutputIterator result, size_type n) {
+        static_assert(std::is_nothrow_assignable<decltype(*result), T&&>::value,
+                      "mpmc_queue: move-assigning an element to *result must not throw");
+        if (n == 0)
+            return 0;
+        size_type pos;
+        const size_type k = claim_pop(n, pos);
+        for (size_type i = 0; i < k; ++i, ++result) {
+            cell& c = cells[(pos + i) & mask];
+            *result = MyStl::move(*c.ptr());
+            MyStl::destroy(c.ptr());
+            //留给下一轮的生产者
+            c.seq.store(pos + i + cap, std::memory_order_release);
+        }
+        if (k)
+            notify(not_full, push_waiters, k);
+        return k;
+    }
+
+    template <typename T>
+    template <typename ForwardIterator>
+    void mpmc_queue<T>::push_n(ForwardIterator first, size_type n) {
+        while (n) {
+            size_type done = 0;
+            wait_until([&]() { return (done = try_push_n(first, n)) != 0; }, not_full, push_waiters);
+            for (size_type i = 0; i < done; ++i)
+                ++first;
+            n -= done;
+        }
+    }
+
+    template <typename T>
+    template <typename Op>
+    void mpmc_queue<T>::wait_until(Op op, std::atomic<uint32_t>& word, std::atomic<uint32_t>& waiters) {
+        for (int i = 0; i < spin_limit; ++i) {
+            if (op())
+                return;
+            cpu_relax();
+        }
+        //线程数多于核数时对方可能没有在运行，先让出时间片
+        for (int i = 0; i < yield_limit; ++i) {
+            if (op())
+                return;
+            std::this_thread::yield();
+        }
+        for (;;) {
+            //先记下futex字再登记，之后对方的notify要么让重试成功，要么改变futex字使睡眠立即返回
+            const uint32_t key = word.load(std::memory_order_acquire);
+            waiters.fetch_add(1, std::memory_order_seq_cst);
+            if (op()) {
+                waiters.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+            futex_wait(&word, key);
+            waiters.fetch_sub(1, std::memory_order_relaxed);
+            if (op())
+                return;
+        }
+    }
+}
+
+#endif //MYSTL_MPMC_QUEUE_H
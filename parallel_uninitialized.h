@@ -0,0 +1,168 @@
+
+#ifndef MYSTL_PARALLEL_UNINITIALIZED_H
+#define MYSTL_PARALLEL_UNINITIALIZED_H
+
+//uninitialized.h的并行版本。对于非常大的区间，把区间均分给线程池中的线程分别构造
+//只有随机访问迭代器才能被切分，其余迭代器直接退化为串行版本
+//只有可平凡拷贝的类型才会并行：其余类型的拷贝构造可能通过pool_alloc分配内存，而内存池不是线程安全的
+#include <exception>
+#include <type_traits>
+#include "uninitialized.h"
+#include "thread_pool.h"
+
+//默认的并行阈值（元素个数），0表示关闭并行，需要使用者主动开启
+#ifndef MYSTL_PARALLEL_THRESHOLD
+#define MYSTL_PARALLEL_THRESHOLD 0
+#endif
+
+namespace MyStl{
+    inline size_t& parallel_threshold_ref() {
+        static size_t threshold = MYSTL_PARALLEL_THRESHOLD;
+        return threshold;
+    }
+
+    //元素个数不少于threshold时使用并行初始化，传入0则关闭
+    inline void set_parallel_threshold(size_t threshold) { parallel_threshold_ref() = threshold; }
+    inline size_t parallel_threshold() { return parallel_threshold_ref(); }
+    template <typename T>
+    inline bool use_parallel(size_t n) {
+        return std::is_trivially_copyable<T>::value
+               && parallel_threshold() != 0 && n >= parallel_threshold()
+               && thread_pool::instance().concurrency() > 1;
+    }
+
+    //把[0, n)切分成若干块，每块交给一个线程执行construct_chunk(b, e)
+    //construct_chunk要么完整构造[b, e)，要么析构已构造的部分并抛出异常（与串行的uninitialized函数一致）
+    //只要有一块失败，其余已经构造成功的块就通过destroy_chunk(b, e)析构，然后把第一个异常抛给调用者
+    template <typename ConstructChunk, typename DestroyChunk>
+    void parallel_construct(size_t n, ConstructChunk construct_chunk, DestroyChunk destroy_chunk) {
+        thread_pool& pool = thread_pool::instance();
+        const size_t chunks = pool.concurrency();
+        const size_t step = (n + chunks - 1) / chunks;
+        bool built[thread_pool::max_workers + 1] = {};
+        std::exception_ptr error;
+        std::mutex error_mtx;
+
+        pool.run(chunks, [&](size_t i) {
+            size_t b = i * step < n ? i * step : n;
+            size_t e = b + step < n ? b + step : n;
+            try {
+                if (b != e)
+                    construct_chunk(b, e);
+                built[i] = true;
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mtx);
+                if (!error)
+                    error = std::current_exception();
+            }
+        });
+
+        if (error) {
+            for (size_t i = 0; i < chunks; ++i) {
+                size_t b = i * step < n ? i * step : n;
+                size_t e = b + step < n ? b + step : n;
+                if (built[i] && b != e)
+                    destroy_chunk(b, e);
+            }
+            std::rethrow_exception(error);
+        }
+    }
+
+    //parallel_uninitialized_copy
+    template <typename InputIterator, typename ForwardIterator>
+    inline ForwardIterator parallel_uninitialized_copy(InputIterator first,
+                                                       InputIterator last,
+                                                       ForwardIterator result) {
+        return _parallel_uninitialized_copy(first, last, result,
+                                            iterator_category_t<InputIterator>(),
+                                            iterator_category_t<ForwardIterator>());
+    }
+
+    //不支持切分的迭代器，使用串行版本
+    template <typename InputIterator, typename ForwardIterator, typename Tag1, typename Tag2>
+    inline ForwardIterator _parallel_uninitialized_copy(InputIterator first,
+                                                        InputIterator last,
+                                                        ForwardIterator result,
+                                                        Tag1, Tag2) {
+        return MyStl::uninitialized_copy(first, last, result);
+    }
+
+    template <typename RandomAccessIterator1, typename RandomAccessIterator2>
+    RandomAccessIterator2 _parallel_uninitialized_copy(RandomAccessIterator1 first,
+                                                       RandomAccessIterator1 last,
+                                                       RandomAccessIterator2 result,
+                                                       random_access_iterator_tag,
+                                                       random_access_iterator_tag) {
+        const size_t n = last - first;
+        if (!use_parallel<typename iterator_traits<RandomAccessIterator2>::value_type>(n))
+            return MyStl::uninitialized_copy(first, last, result);
+        parallel_construct(n,
+                           [&](size_t b, size_t e) {
+                               MyStl::uninitialized_copy(first + b, first + e, result + b);
+                           },
+                           [&](size_t b, size_t e) { MyStl::destroy(result + b, result + e); });
+        return result + n;
+    }
+
+    //parallel_uninitialized_fill
+    template <typename ForwardIterator, typename T>
+    inline void parallel_uninitialized_fill(ForwardIterator first,
+                                            ForwardIterator last,
+                                            const T& value) {
+        _parallel_uninitialized_fill(first, last, value, iterator_category_t<ForwardIterator>());
+    }
+
+    template <typename ForwardIterator, typename T, typename Tag>
+    inline void _parallel_uninitialized_fill(ForwardIterator first,
+                                             ForwardIterator last,
+                                             const T& value,
+                                             Tag) {
+        MyStl::uninitialized_fill(first, last, value);
+    }
+
+    template <typename RandomAccessIterator, typename T>
+    void _parallel_uninitialized_fill(RandomAccessIterator first,
+                                      RandomAccessIterator last,
+                                      const T& value,
+                                      random_access_iterator_tag) {
+        const size_t n = last - first;
+        if (!use_parallel<typename iterator_traits<RandomAccessIterator>::value_type>(n)) {
+            MyStl::uninitialized_fill(first, last, value);
+            return;
+        }
+        parallel_construct(n,
+                           [&](size_t b, size_t e) { MyStl::uninitialized_fill(first + b, first + e, value); },
+                           [&](size_t b, size_t e) { MyStl::destroy(first + b, first + e); });
+    }
+
+    //parallel_uninitialized_fill_n
+    template <typename ForwardIterator, typename T>
+    inline ForwardIterator parallel_uninitialized_fill_n(ForwardIterator first,
+                                                         size_t n,
+                                                         const T& value) {
+        return _parallel_uninitialized_fill_n(first, n, value, iterator_category_t<ForwardIterator>());
+    }
+
+    template <typename ForwardIterator, typename T, typename Tag>
+    inline ForwardIterator _parallel_uninitialized_fill_n(ForwardIterator first,
+                                                          size_t n,
+                                                          const T& value,
+                                                          Tag) {
+        return MyStl::uninitialized_fill_n(first, n, value);
+    }
+
+    template <typename RandomAccessIterator, typename T>
+    RandomAccessIterator _parallel_uninitialized_fill_n(RandomAccessIterator first,
+                                                        size_t n,
+                                                        const T& value,
+                                                        random_access_iterator_tag) {
+        if (!use_parallel<typename iterator_traits<RandomAccessIterator>::value_type>(n))
+            return MyStl::uninitialized_fill_n(first, n, value);
+        parallel_construct(n,
+                           [&](size_t b, size_t e) { MyStl::uninitialized_fill_n(first + b, e - b, value); },
+                           [&](size_t b, size_t e) { MyStl::destroy(first + b, first + e); });
+        return first + n;
+    }
+}
+
+#endif //MYSTL_PARALLEL_UNINITIALIZED_H
@@ -0,0 +1,527 @@
+
+#ifndef MYSTL_PERSISTENT_VECTOR_H
+#define MYSTL_PERSISTENT_VECTOR_H
+
+//不可变、结构共享的vector，参考Clojure的PersistentVector
+//元素保存在32叉的前缀树中，每个叶子存放32个元素；最后一个叶子(tail)单独保存，使得push_back均摊O(1)
+//拷贝只需要增加根节点和tail的引用计数，所以快照是O(1)的；修改时只复制从根到目标叶子的路径，即O(log32 n)
+//transient_vector用于批量修改：只有被自己独占(引用计数为1)的节点才会原地修改，否则先复制再修改
+//引用计数是原子的，快照可以交给其它线程读取和析构，最后一个引用所在的线程负责释放节点
+//节点通过new_allocator(::operator new)分配而不是pool_alloc，因为内存池不是线程安全的
+//同一个对象的修改仍然只能在一个线程中进行
+#include <atomic>
+#include <type_traits>
+#include <initializer_list>
+#include <stdexcept>
+#include "new_allocator.h"
+#include "iterator.h"
+#include "construct.h"
+#include "uninitialized.h"
+
+namespace MyStl{
+    template <typename T>
+    class persistent_vector;
+    template <typename T>
+    class transient_vector;
+    template <typename T>
+    struct pvector_iterator;
+
+    //persistent_vector和transient_vector的公共部分：树的结构和所有修改算法
+    //修改算法都是原地进行的，对共享节点会先复制路径，所以对一个刚拷贝出来的对象调用它们就得到了持久化的语义
+    template <typename T>
+    class pvector_base{
+    public:
+        using value_type        = T;
+        using size_type         = size_t;
+        using difference_type   = ptrdiff_t;
+        using reference         = const T&;
+        using const_reference   = const T&;
+        using const_iterator    = pvector_iterator<T>;
+        using iterator          = const_iterator;
+
+        friend struct pvector_iterator<T>;
+        friend class persistent_vector<T>;
+        friend class transient_vector<T>;
+
+    protected:
+        enum { bits = 5, width = 1 << bits, mask = width - 1 };
+
+        struct node{
+            std::atomic<size_t> refs;
+            node() : refs(1) {}
+        };
+        //内部节点，children在第level - bits层
+        struct inner_node : node{
+            node* child[width];
+            inner_node() : node() {
+                for (size_t i = 0; i < width; ++i)
+                    child[i] = nullptr;
+            }
+        };
+        //叶子节点，count记录已经构造的元素个数
+        struct leaf_node : node{
+            size_t count;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage[width];
+            leaf_node() : node(), count(0) {}
+            T* vals() { return reinterpret_cast<T*>(storage); }
+            const T* vals() const { return reinterpret_cast<const T*>(storage); }
+        };
+        using inner_alloc = new_allocator<inner_node>;
+        using leaf_alloc = new_allocator<leaf_node>;
+
+        size_type cnt;
+        size_type shift;    //根节点所在的层，叶子所在的层为0
+        node* root;         //元素不超过32个时为空
+        node* tail;         //容器为空时为空
+
+    protected:
+        /*节点的分配、释放与复制*/
+        static inner_node* as_inner(node* p) { return static_cast<inner_node*>(p); }
+        static leaf_node* as_leaf(node* p) { return static_cast<leaf_node*>(p); }
+        static const leaf_node* as_leaf(const node* p) { return static_cast<const leaf_node*>(p); }
+
+        static inner_node* new_inner() {
+            inner_node* p = inner_alloc::allocate();
+            MyStl::construct(p);
+            return p;
+        }
+        static leaf_node* new_leaf() {
+            leaf_node* p = leaf_alloc::allocate();
+            MyStl::construct(p);
+            return p;
+        }
+        //只释放节点本身，不处理子节点
+        static void free_inner(inner_node* p) {
+            p->~inner_node();
+            inner_alloc::deallocate(p);
+        }
+        static void free_leaf(leaf_node* p) {
+            MyStl::destroy(p->vals(), p->vals() + p->count);
+            p->~leaf_node();
+            leaf_alloc::deallocate(p);
+        }
+        static void retain(node* p) {
+            if (p)
+                p->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        //引用计数减为0时释放节点，内部节点还需要递归释放子节点
+        static void release(node* p, size_type level);
+        static bool unique(node* p) { return p->refs.load(std::memory_order_acquire) == 1; }
+        static leaf_node* copy_leaf(const leaf_node* p);
+        static inner_node* copy_inner(const inner_node* p);
+        //保证slot指向的节点被自己独占，必要时复制一份替换slot。复制失败时slot保持不变
+        static leaf_node* editable_leaf(node*& slot);
+        static inner_node* editable_inner(node*& slot, size_type level);
+        //从第level层开始建立一条只有最左分支的路径，最底层挂上leaf
+        static node* new_path(size_type level, node* leaf);
+
+        /*内调函数*/
+        //树中保存的元素个数，即tail第一个元素的下标
+        size_type tailoff() const { return cnt < width ? 0 : ((cnt - 1) >> bits) << bits; }
+        //下标n所在的叶子
+        const leaf_node* leaf_for(size_type n) const;
+        //把已满的tail挂到树上
+        void push_tail(node*& slot, size_type level, node* full);
+        void do_set(node*& slot, size_type level, size_type n, const T& value);
+        //把树中最后一个叶子摘除
+        void pop_tail(node*& slot, size_type level);
+
+        //原地修改
+        void push_back_in_place(const T& value);
+        void set_in_place(size_type n, const T& value);
+        void pop_back_in_place();
+
+        pvector_base() : cnt(0), shift(bits), root(nullptr), tail(nullptr) {}
+        pvector_base(const pvector_base& rhs) : cnt(rhs.cnt), shift(rhs.shift), root(rhs.root), tail(rhs.tail) {
+            retain(root);
+            retain(tail);
+        }
+        ~pvector_base() {
+            release(root, shift);
+            release(tail, 0);
+        }
+        void swap(pvector_base& rhs) {
+            std::swap(cnt, rhs.cnt);
+            std::swap(shift, rhs.shift);
+            std::swap(root, rhs.root);
+            std::swap(tail, rhs.tail);
+        }
+
+    public:
+        //元素访问，只读
+        const_reference operator[](size_type n) const { return leaf_for(n)->vals()[n & mask]; }
+        const_reference at(size_type n) const {
+            if (n >= cnt)
+                throw std::out_of_range("persistent_vector::at");
+            return (*this)[n];
+        }
+        const_reference front() const { return (*this)[0]; }
+        const_reference back() const { return (*this)[cnt - 1]; }
+
+        //迭代器
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, cnt); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+        //容量
+        size_type size() const { return cnt; }
+        bool empty() const { return cnt == 0; }
+        size_type max_size() const { return size_type(-1) / sizeof(value_type); }
+    };
+
+    template <typename T>
+    void pvector_base<T>::release(node* p, size_type level) {
+        if (!p || p->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+        if (level == 0) {
+            free_leaf(as_leaf(p));
+        } else {
+            inner_node* n = as_inner(p);
+            for (size_type i = 0; i < width; ++i)
+                release(n->child[i], level - bits);
+            free_inner(n);
+        }
+    }
+
+    template <typename T>
+    typename pvector_base<T>::leaf_node* pvector_base<T>::copy_leaf(const leaf_node* p) {
+        leaf_node* c = new_leaf();
+        try {
+            MyStl::uninitialized_copy(p->vals(), p->vals() + p->count, c->vals());
+        } catch (...) {
+            free_leaf(c);
+            throw;
+        }
+        c->count = p->count;
+        return c;
+    }
+
+    template <typename T>
+    typename pvector_base<T>::inner_node* pvector_base<T>::copy_inner(const inner_node* p) {
+        inner_node* c = new_inner();
+        for (size_type i = 0; i < width; ++i) {
+            c->child[i] = p->child[i];
+            retain(c->child[i]);
+        }
+        return c;
+    }
+
+    template <typename T>
+    typename pvector_base<T>::leaf_node* pvector_base<T>::editable_leaf(node*& slot) {
+        if (unique(slot))
+            return as_leaf(slot);
+        leaf_node* c = copy_leaf(as_leaf(slot));
+        release(slot, 0);
+        slot = c;
+        return c;
+    }
+
+    template <typename T>
+    typename pvector_base<T>::inner_node* pvector_base<T>::editable_inner(node*& slot, size_type level) {
+        if (unique(slot))
+            return as_inner(slot);
+        inner_node* c = copy_inner(as_inner(slot));
+        release(slot, level);
+        slot = c;
+        return c;
+    }
+
+    template <typename T>
+    typename pvector_base<T>::node* pvector_base<T>::new_path(size_type level, node* leaf) {
+        if (level == 0)
+            return leaf;
+        inner_node* r = new_inner();
+        try {
+            r->child[0] = new_path(level - bits, leaf);
+        } catch (...) {
+            free_inner(r);
+            throw;
+        }
+        return r;
+    }
+
+    template <typename T>
+    const typename pvector_base<T>::leaf_node* pvector_base<T>::leaf_for(size_type n) const {
+        if (n >= tailoff())
+            return as_leaf(tail);
+        node* p = root;
+        for (size_type level = shift; level > 0; level -= bits)
+            p = as_inner(p)->child[(n >> level) & mask];
+        return as_leaf(p);
+    }
+
+    template <typename T>
+    void pvector_base<T>::push_tail(node*& slot, size_type level, node* full) {
+        inner_node* n = editable_inner(slot, level);
+        size_type sub = ((cnt - 1) >> level) & mask;
+        if (level == bits)
+            n->child[sub] = full;
+        else if (n->child[sub])
+            push_tail(n->child[sub], level - bits, full);
+        else
+            n->child[sub] = new_path(level - bits, full);
+    }
+
+    template <typename T>
+    void pvector_base<T>::do_set(node*& slot, size_type level, size_type n, const T& value) {
+        if (level == 0) {
+            editable_leaf(slot)->vals()[n & mask] = value;
+        } else {
+            inner_node* p = editable_inner(slot, level);
+            do_set(p->child[(n >> level) & mask], level - bits, n, value);
+        }
+    }
+
+    template <typename T>
+    void pvector_base<T>::pop_tail(node*& slot, size_type level) {
+        size_type sub = ((cnt - 2) >> level) & mask;
+        if (level > bits) {
+            inner_node* p = editable_inner(slot, level);
+            pop_tail(p->child[sub], level - bits);
+            if (p->child[sub] == nullptr && sub == 0) {
+                release(slot, level);
+                slot = nullptr;
+            }
+        } else if (sub == 0) {
+            release(slot, level);
+            slot = nullptr;
+        } else {
+            inner_node* p = editable_inner(slot, level);
+            release(p->child[sub], 0);
+            p->child[sub] = nullptr;
+        }
+    }
+
+    template <typename T>
+    void pvector_base<T>::push_back_in_place(const T& value) {
+        //tail还有空位，直接在tail中构造
+        if (cnt - tailoff() < width && tail) {
+            leaf_node* l = editable_leaf(tail);
+            MyStl::construct(l->vals() + l->count, value);
+            ++l->count;
+            ++cnt;
+            return;
+        }
+        //先构造新的tail，构造失败时容器不受影响
+        leaf_node* new_tail = new_leaf();
+        try {
+            MyStl::construct(new_tail->vals(), value);
+        } catch (...) {
+            free_leaf(new_tail);
+            throw;
+        }
+        new_tail->count = 1;
+        if (tail) {
+            //tail已满，把它挂到树上；分配内部节点失败时释放new_tail，树的内容不变
+            try {
+                if (!root)
+                    root = new_inner();
+                if ((cnt >> bits) > (size_type(1) << shift)) {
+                    //根节点已满，树长高一层
+                    inner_node* new_root = new_inner();
+                    try {
+                        new_root->child[1] = new_path(shift, tail);
+                    } catch (...) {
+                        free_inner(new_root);
+                        throw;
+                    }
+                    new_root->child[0] = root;
+                    root = new_root;
+                    shift += bits;
+                } else {
+                    push_tail(root, shift, tail);
+                }
+            } catch (...) {
+                free_leaf(new_tail);
+                throw;
+            }
+        }
+        tail = new_tail;
+        ++cnt;
+    }
+
+    template <typename T>
+    void pvector_base<T>::set_in_place(size_type n, const T& value) {
+        if (n >= tailoff())
+            editable_leaf(tail)->vals()[n & mask] = value;
+        else
+            do_set(root, shift, n, value);
+    }
+
+    template <typename T>
+    void pvector_base<T>::pop_back_in_place() {
+        if (cnt == 1) {
+            release(tail, 0);
+            tail = nullptr;
+            cnt = 0;
+            return;
+        }
+        if (cnt - tailoff() > 1) {
+            leaf_node* l = editable_leaf(tail);
+            --l->count;
+            MyStl::destroy(l->vals() + l->count);
+            --cnt;
+            return;
+        }
+        //tail中只有一个元素，树中最后一个叶子成为新的tail
+        node* new_tail = const_cast<leaf_node*>(leaf_for(cnt - 2));
+        retain(new_tail);
+        pop_tail(root, shift);
+        if (root && shift > bits && as_inner(root)->child[1] == nullptr) {
+            //根节点只剩一个子节点，树降低一层
+            node* new_root = as_inner(root)->child[0];
+            retain(new_root);
+            release(root, shift);
+            root = new_root;
+            shift -= bits;
+        }
+        if (!root)
+            shift = bits;
+        release(tail, 0);
+        tail = new_tail;
+        --cnt;
+    }
+
+    //持久化的vector，所有修改操作都返回一个新的对象，原对象保持不变
+    template <typename T>
+    class persistent_vector : public pvector_base<T>{
+        using base = pvector_base<T>;
+        friend class transient_vector<T>;
+    public:
+        using size_type = typename base::size_type;
+
+        persistent_vector() : base() {}
+        persistent_vector(const persistent_vector& rhs) : base(rhs) {}
+        persistent_vector(persistent_vector&& rhs) : base() { base::swap(rhs); }
+        template <typename InputIterator>
+        persistent_vector(InputIterator first, InputIterator last) : base() {
+            for (; first != last; ++first)
+                this->push_back_in_place(*first);
+        }
+        persistent_vector(std::initializer_list<T> il) : persistent_vector(il.begin(), il.end()) {}
+
+        persistent_vector& operator=(const persistent_vector& rhs) {
+            persistent_vector temp(rhs);
+            swap(temp);
+            return *this;
+        }
+
+        persistent_vector push_back(const T& value) const {
+            persistent_vector r(*this);
+            r.push_back_in_place(value);
+            return r;
+        }
+        persistent_vector set(size_type n, const T& value) const {
+            persistent_vector r(*this);
+            r.set_in_place(n, value);
+            return r;
+        }
+        persistent_vector pop_back() const {
+            persistent_vector r(*this);
+            r.pop_back_in_place();
+            return r;
+        }
+
+        //生成用于批量修改的transient_vector，O(1)
+        transient_vector<T> transient() const { return transient_vector<T>(*this); }
+
+        void swap(persistent_vector& rhs) { base::swap(rhs); }
+    };
+
+    //可以原地修改的版本，用于批量修改；修改完成后调用persistent()得到新的快照
+    template <typename T>
+    class transient_vector : public pvector_base<T>{
+        using base = pvector_base<T>;
+    public:
+        using size_type = typename base::size_type;
+
+        transient_vector() : base() {}
+        explicit transient_vector(const persistent_vector<T>& v) : base(v) {}
+        transient_vector(transient_vector&& rhs) : base() { base::swap(rhs); }
+        transient_vector(const transient_vector&) = delete;
+        transient_vector& operator=(const transient_vector&) = delete;
+
+        void push_back(const T& value) { this->push_back_in_place(value); }
+        void set(size_type n, const T& value) { this->set_in_place(n, value); }
+        void pop_back() { this->pop_back_in_place(); }
+
+        //把当前内容转移给一个persistent_vector，transient变为空
+        persistent_vector<T> persistent() {
+            persistent_vector<T> r;
+            r.base::swap(*this);
+            return r;
+        }
+    };
+
+    //只读的随机访问迭代器，缓存当前所在的叶子，顺序遍历时每32个元素才需要查找一次
+    template <typename T>
+    struct pvector_iterator{
+        using iterator_category = random_access_iterator_tag;
+        using value_type        = T;
+        using difference_type   = ptrdiff_t;
+        using pointer           = const T*;
+        using reference         = const T&;
+        using self              = pvector_iterator;
+        using container         = pvector_base<T>;
+
+        const container* vec;
+        size_t index;
+        const T* block;     //当前叶子的元素数组
+
+        pvector_iterator() : vec(nullptr), index(0), block(nullptr) {}
+        pvector_iterator(const container* v, size_t n) : vec(v), index(n), block(nullptr) { sync(); }
+
+        void sync() {
+            block = index < vec->cnt ? vec->leaf_for(index)->vals() : nullptr;
+        }
+
+        reference operator*() const { return block[index & container::mask]; }
+        pointer operator->() const { return &(operator*()); }
+        reference operator[](difference_type n) const { return (*vec)[index + n]; }
+
+        self& operator++() {
+            if ((++index & container::mask) == 0)
+                sync();
+            return *this;
+        }
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        self& operator--() {
+            if ((index-- & container::mask) == 0 || !block)
+                sync();
+            return *this;
+        }
+        self operator--(int) {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+        self& operator+=(difference_type n) {
+            index += n;
+            sync();
+            return *this;
+        }
+        self& operator-=(difference_type n) { return *this += -n; }
+        self operator+(difference_type n) const {
+            self tmp = *this;
+            return tmp += n;
+        }
+        self operator-(difference_type n) const {
+            self tmp = *this;
+            return tmp -= n;
+        }
+        difference_type operator-(const self& rhs) const {
+            return difference_type(index) - difference_type(rhs.index);
+        }
+
+        bool operator==(const self& rhs) const { return index == rhs.index; }
+        bool operator!=(const self& rhs) const { return index != rhs.index; }
+        bool operator<(const self& rhs) const { return index < rhs.index; }
+    };
+}
+
+#endif //MYSTL_PERSISTENT_VECTOR_H
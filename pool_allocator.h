@@ -3,6 +3,9 @@
 #define MYSTL_POOL_ALLOCATOR_H
 
 #include "move.h"
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
 
 namespace MyStl{
     //按照现在stl说法，当size > _S_max_bytes时，也应该直接使用new进行创建，也就是new_allocator
@@ -0,0 +1,19 @@
+
+#ifndef MYSTL_PREFETCH_H
+#define MYSTL_PREFETCH_H
+
+//软件预取：提前把即将访问的缓存行读入缓存，让内存访问和当前的计算重叠
+//预取只是提示，地址无效时也不会出错；定义MYSTL_NO_PREFETCH可以关闭，用来对比效果
+
+namespace MyStl{
+    //即将读取p
+    inline void prefetch(const void* p) {
+#if defined(__GNUC__) && !defined(MYSTL_NO_PREFETCH)
+        __builtin_prefetch(p, 0, 3);
+#else
+        (void)p;
+#endif
+    }
+}
+
+#endif //MYSTL_PREFETCH_H
@@ -21,7 +21,7 @@ namespace MyStl{
         priority_queue() : con() {}
         template <typename InputIter>
         priority_queue(InputIter first, InputIter last) : con(first, last)
-        { make_heap(con.begin(), con.end()); }
+        { MyStl::make_heap(con.begin(), con.end()); }
         
         
         const_reference top() const { return con.front(); }
@@ -29,10 +29,19 @@ namespace MyStl{
         size_type size() const { return con.size(); }
         void push( const value_type& value ) {
             con.push_back(value);
-            push_heap(con.begin(), con.end());
+            MyStl::push_heap(con.begin(), con.end());
+        }
+        void push(value_type&& value) {
+            con.push_back(MyStl::move(value));
+            MyStl::push_heap(con.begin(), con.end());
+        }
+        template <typename... Args>
+        void emplace(Args&&... args) {
+            con.emplace_back(MyStl::forward<Args>(args)...);
+            MyStl::push_heap(con.begin(), con.end());
         }
         void pop() {
-            pop_heap(con.begin(), con.end());
+            MyStl::pop_heap(con.begin(), con.end());
             con.pop_back();
         }
 
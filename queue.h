@@ -3,6 +3,7 @@
 #define MYSTL_QUEUE_H
 
 #include "deque.h"
+#include "ring_deque.h"
 namespace MyStl{
     template<typename T, typename Container = MyStl::deque<T>>
     class queue{
@@ -33,6 +34,9 @@ namespace MyStl{
         reference back() { return con.back(); }
         const_reference back() const { return con.back(); }
         void push(const value_type& value) { con.push_back(value); }
+        void push(value_type&& value) { con.push_back(MyStl::move(value)); }
+        template <typename... Args>
+        void emplace(Args&&... args) { con.emplace_back(MyStl::forward<Args>(args)...); }
         void pop() { con.pop_front(); }
     };
 
@@ -66,6 +70,13 @@ namespace MyStl{
         return !(lhs < rhs);
     }
 
+    //底层使用BufSiz个元素的缓冲区的deque，例如block_queue<int, 1024>使用4KB的缓冲区
+    template <typename T, size_t BufSiz>
+    using block_queue = queue<T, MyStl::deque<T, BufSiz>>;
+
+    //底层使用环形map的ring_deque，只在两端进出的队列不需要重新居中map
+    template <typename T, size_t BufSiz = 0>
+    using ring_queue = queue<T, MyStl::ring_deque<T, BufSiz>>;
 
 }
 #endif //MYSTL_QUEUE_H
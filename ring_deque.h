@@ -0,0 +1,364 @@
+
+#ifndef MYSTL_RING_DEQUE_H
+#define MYSTL_RING_DEQUE_H
+
+//中控器为环形数组的deque
+//deque的map是线性的，只在尾部push、头部pop的队列会不断地向map的一端移动，每走到头就要在reallocate_map中重新居中或者分配新map
+//ring_deque的map是容量为2的幂的环形数组，头尾节点的下标取模后回绕，所以永远不需要重新居中
+//只有存活的缓冲区个数超过map容量时才会把map扩大一倍；pop之后存活缓冲区不到map容量的1/4时把map缩小一半
+//所以突发的高峰过去之后map的内存也会还回去，扩大和缩小之间留有余量，稳定的队列不会反复分配map
+#include "deque.h"
+
+namespace MyStl{
+    template <typename Deque, typename Ref, typename Ptr>
+    struct ring_deque_iterator;
+
+    template <typename T, size_t BufSiz = 0>
+    class ring_deque{
+    public:
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using iterator = ring_deque_iterator<ring_deque, T&, T*>;
+        using const_iterator = ring_deque_iterator<const ring_deque, const T&, const T*>;
+        using reverse_iter = reverse_iterator<iterator>;
+        using const_reverse_iter = reverse_iterator<const_iterator>;
+
+    protected:
+        using map_pointer = pointer*;
+        using map_alloc = pool_alloc<pointer>;
+        using block_alloc = deque_block_alloc<value_type>;
+
+        //map[(head_node + k) & (map_size - 1)]是第k个缓冲区，共有num_nodes个
+        //第一个元素位于第一个缓冲区的head处，元素个数为len
+        map_pointer map = nullptr;
+        size_type map_size = 0;
+        size_type head_node = 0;
+        size_type num_nodes = 0;
+        size_type head = 0;
+        size_type len = 0;
+        //与deque相同的备用缓冲区
+        enum { max_spare_nodes = 2 };
+        pointer spare_nodes[max_spare_nodes];
+        size_type spare_count = 0;
+
+        static constexpr size_type buffer_size() { return deque_buf_size(BufSiz, sizeof(T)); }
+        static size_type init_map_size() { return 8; }
+
+        /*内存操作*/
+        pointer allocate_node() {
+            return spare_count ? spare_nodes[--spare_count] : block_alloc::allocate(buffer_size());
+        }
+        void deallocate_node(pointer ptr) {
+            if (spare_count < max_spare_nodes)
+                spare_nodes[spare_count++] = ptr;
+            else
+                block_alloc::deallocate(ptr);
+        }
+        void release_spare_nodes() {
+            while (spare_count)
+                block_alloc::deallocate(spare_nodes[--spare_count]);
+        }
+        //第k个缓冲区在map中的位置
+        pointer& node_at(size_type k) const { return map[(head_node + k) & (map_size - 1)]; }
+        //按逻辑顺序把节点拷贝到大小为new_map_size的新map的开头
+        void move_map(map_pointer new_map, size_type new_map_size);
+        //map已满时扩大一倍
+        void grow_map();
+        //pop之后存活缓冲区不到map容量的1/4时缩小一半，只为节省内存，分配失败时保留原map
+        void shrink_map_if_sparse();
+        //在首尾增加或释放一个缓冲区
+        void add_node_at_back();
+        void add_node_at_front();
+        void remove_node_at_back() {
+            deallocate_node(node_at(num_nodes - 1));
+            --num_nodes;
+        }
+        void remove_node_at_front() {
+            deallocate_node(node_at(0));
+            head_node = (head_node + 1) & (map_size - 1);
+            --num_nodes;
+        }
+        //元素为空时释放全部缓冲区，回到初始状态
+        void reset_if_empty() {
+            if (len == 0) {
+                while (num_nodes)
+                    remove_node_at_back();
+                head = 0;
+            }
+        }
+        template <typename InputIterator>
+        void copy_initialize(InputIterator first, InputIterator last) {
+            try {
+                for (; first != last; ++first)
+                    push_back(*first);
+            } catch (...) {
+                clear();
+                release();
+                throw;
+            }
+        }
+        void release() {
+            while (num_nodes)
+                remove_node_at_back();
+            release_spare_nodes();
+            if (map)
+                map_alloc::deallocate(map, map_size);
+            map = nullptr;
+            map_size = 0;
+        }
+
+    public:
+        /*构造与析构*/
+        ring_deque() {}
+        ring_deque(size_type n, const value_type& value) {
+            try {
+                for (; n; --n)
+                    push_back(value);
+            } catch (...) {
+                clear();
+                release();
+                throw;
+            }
+        }
+        ring_deque(const ring_deque& rhs) { copy_initialize(rhs.begin(), rhs.end()); }
+        ring_deque(const std::initializer_list<T>& il) { copy_initialize(il.begin(), il.end()); }
+        ring_deque& operator=(const ring_deque& rhs) {
+            if (&rhs != this) {
+                ring_deque temp(rhs);
+                swap(temp);
+            }
+            return *this;
+        }
+        ~ring_deque() {
+            clear();
+            release();
+        }
+
+        //元素访问
+        reference operator[](size_type n) {
+            const size_type offset = head + n;
+            return node_at(offset / buffer_size())[offset % buffer_size()];
+        }
+        const_reference operator[](size_type n) const {
+            const size_type offset = head + n;
+            return node_at(offset / buffer_size())[offset % buffer_size()];
+        }
+        reference front() { return node_at(0)[head]; }
+        const_reference front() const { return node_at(0)[head]; }
+        reference back() { return (*this)[len - 1]; }
+        const_reference back() const { return (*this)[len - 1]; }
+
+        //迭代器
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, len); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, len); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+        reverse_iter rbegin() { return reverse_iter(end()); }
+        reverse_iter rend() { return reverse_iter(begin()); }
+
+        //容量
+        size_type size() const { return len; }
+        bool empty() const { return len == 0; }
+        //map中能放下的缓冲区个数
+        size_type map_capacity() const { return map_size; }
+
+        //修改器
+        //在首尾直接构造元素，push_back/push_front都转发给它们
+        template <typename... Args>
+        void emplace_back(Args&&... args);
+        template <typename... Args>
+        void emplace_front(Args&&... args);
+        void push_back(const value_type& value) { emplace_back(value); }
+        void push_back(value_type&& value) { emplace_back(MyStl::move(value)); }
+        void push_front(const value_type& value) { emplace_front(value); }
+        void push_front(value_type&& value) { emplace_front(MyStl::move(value)); }
+        void pop_back() {
+            MyStl::destroy(&back());
+            --len;
+            reset_if_empty();
+            if (len && head + len <= (num_nodes - 1) * buffer_size())
+                remove_node_at_back();
+            shrink_map_if_sparse();
+        }
+        void pop_front() {
+            MyStl::destroy(&front());
+            ++head;
+            --len;
+            reset_if_empty();
+            if (head == buffer_size()) {
+                remove_node_at_front();
+                head = 0;
+            }
+            shrink_map_if_sparse();
+        }
+        void clear() {
+            for (size_type i = 0; i < len; ++i)
+                MyStl::destroy(&(*this)[i]);
+            len = 0;
+            reset_if_empty();
+            shrink_map_if_sparse();
+        }
+        void swap(ring_deque& rhs) {
+            std::swap(map, rhs.map);
+            std::swap(map_size, rhs.map_size);
+            std::swap(head_node, rhs.head_node);
+            std::swap(num_nodes, rhs.num_nodes);
+            std::swap(head, rhs.head);
+            std::swap(len, rhs.len);
+            //备用缓冲区的大小都相同，各自保留即可
+        }
+    };
+
+    template <typename T, size_t BufSiz>
+    void ring_deque<T, BufSiz>::move_map(map_pointer new_map, size_type new_map_size) {
+        for (size_type k = 0; k < num_nodes; ++k)
+            new_map[k] = node_at(k);
+        if (map)
+            map_alloc::deallocate(map, map_size);
+        map = new_map;
+        map_size = new_map_size;
+        head_node = 0;
+    }
+
+    template <typename T, size_t BufSiz>
+    void ring_deque<T, BufSiz>::grow_map() {
+        size_type new_map_size = map_size ? 2 * map_size : init_map_size();
+        move_map(map_alloc::allocate(new_map_size), new_map_size);
+    }
+
+    template <typename T, size_t BufSiz>
+    void ring_deque<T, BufSiz>::shrink_map_if_sparse() {
+        if (map_size <= init_map_size() || num_nodes * 4 >= map_size)
+            return;
+        //缩小一半后存活缓冲区仍不到一半，要再增长一倍才会重新扩大
+        const size_type new_map_size = map_size / 2;
+        map_pointer new_map;
+        try {
+            new_map = map_alloc::allocate(new_map_size);
+        } catch (...) {
+            return;
+        }
+        move_map(new_map, new_map_size);
+    }
+
+    template <typename T, size_t BufSiz>
+    void ring_deque<T, BufSiz>::add_node_at_back() {
+        if (num_nodes == map_size)
+            grow_map();
+        node_at(num_nodes) = allocate_node();
+        ++num_nodes;
+    }
+
+    template <typename T, size_t BufSiz>
+    void ring_deque<T, BufSiz>::add_node_at_front() {
+        if (num_nodes == map_size)
+            grow_map();
+        head_node = (head_node - 1) & (map_size - 1);
+        try {
+            node_at(0) = allocate_node();
+        } catch (...) {
+            head_node = (head_node + 1) & (map_size - 1);
+            throw;
+        }
+        ++num_nodes;
+    }
+
+    template <typename T, size_t BufSiz>
+    template <typename... Args>
+    void ring_deque<T, BufSiz>::emplace_back(Args&&... args) {
+        const size_type offset = head + len;
+        const bool new_node = offset == num_nodes * buffer_size();
+        if (new_node)
+            add_node_at_back();
+        try {
+            MyStl::construct(&node_at(offset / buffer_size())[offset % buffer_size()], MyStl::forward<Args>(args)...);
+        } catch (...) {
+            if (new_node)
+                remove_node_at_back();
+            throw;
+        }
+        ++len;
+    }
+
+    template <typename T, size_t BufSiz>
+    template <typename... Args>
+    void ring_deque<T, BufSiz>::emplace_front(Args&&... args) {
+        const bool new_node = head == 0;
+        if (new_node)
+            add_node_at_front();
+        const size_type new_head = (new_node ? buffer_size() : head) - 1;
+        try {
+            MyStl::construct(&node_at(0)[new_head], MyStl::forward<Args>(args)...);
+        } catch (...) {
+            if (new_node)
+                remove_node_at_front();
+            throw;
+        }
+        head = new_head;
+        ++len;
+    }
+
+    template <typename T, size_t BufSiz>
+    bool operator==(const ring_deque<T, BufSiz>& lhs, const ring_deque<T, BufSiz>& rhs) {
+        if (lhs.size() != rhs.size())
+            return false;
+        for (size_t i = 0; i < lhs.size(); ++i)
+            if (!(lhs[i] == rhs[i]))
+                return false;
+        return true;
+    }
+
+    template <typename T, size_t BufSiz>
+    bool operator!=(const ring_deque<T, BufSiz>& lhs, const ring_deque<T, BufSiz>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    //和soa_iterator一样只保存容器指针和下标，解引用时通过operator[]定位元素
+    template <typename Deque, typename Ref, typename Ptr>
+    struct ring_deque_iterator{
+        using iterator_category = random_access_iterator_tag;
+        using value_type        = typename remove_const_t<Deque>::value_type;
+        using difference_type   = ptrdiff_t;
+        using reference         = Ref;
+        using pointer           = Ptr;
+        using self              = ring_deque_iterator;
+
+        Deque* deq;
+        size_t index;
+
+        ring_deque_iterator() : deq(nullptr), index(0) {}
+        ring_deque_iterator(Deque* d, size_t n) : deq(d), index(n) {}
+        //iterator可以转换为const_iterator
+        template <typename D, typename R, typename P>
+        ring_deque_iterator(const ring_deque_iterator<D, R, P>& it) : deq(it.deq), index(it.index) {}
+
+        reference operator*() const { return (*deq)[index]; }
+        pointer operator->() const { return &(*deq)[index]; }
+        reference operator[](difference_type n) const { return (*deq)[index + n]; }
+
+        self& operator++() { ++index; return *this; }
+        self operator++(int) { self tmp = *this; ++index; return tmp; }
+        self& operator--() { --index; return *this; }
+        self operator--(int) { self tmp = *this; --index; return tmp; }
+        self& operator+=(difference_type n) { index += n; return *this; }
+        self& operator-=(difference_type n) { index -= n; return *this; }
+        self operator+(difference_type n) const { return self(deq, index + n); }
+        self operator-(difference_type n) const { return self(deq, index - n); }
+        difference_type operator-(const self& rhs) const {
+            return difference_type(index) - difference_type(rhs.index);
+        }
+
+        bool operator==(const self& rhs) const { return index == rhs.index; }
+        bool operator!=(const self& rhs) const { return index != rhs.index; }
+        bool operator<(const self& rhs) const { return index < rhs.index; }
+    };
+}
+
+#endif //MYSTL_RING_DEQUE_H
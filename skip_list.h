@@ -0,0 +1,308 @@
+
+#ifndef MYSTL_SKIP_LIST_H
+#define MYSTL_SKIP_LIST_H
+
+//跳表：按键有序的关联容器，insert/erase/find/lower_bound的期望复杂度为O(log n)，迭代器按键的升序遍历
+//每个节点有一座高度随机的指针塔，第i层以1/4的概率继续长高，节点连同指针塔一起从内存池对应大小的区块中分配
+//无锁读：所有next指针都是原子变量，插入时先填好新节点再用release发布，读者用acquire读取，不需要加锁
+//写操作(insert/erase/clear)之间仍需使用者串行化，可以和任意多个只读线程(find/lower_bound/contains/遍历)同时进行
+//ConcurrentRead为true时erase只摘下节点不释放，读者可能还在访问它；确认没有读者时调用reclaim()统一释放
+//并发读时元素发布后不能再修改，要修改值请先erase再insert
+#include <atomic>
+#include <functional>
+#include <utility>
+#include <new>
+#include <tuple>
+#include <initializer_list>
+#include "iterator.h"
+#include "pool_allocator.h"
+#include "construct.h"
+#include "move.h"
+#include "vector.h"
+
+namespace MyStl{
+    template <typename Value>
+    struct skip_node{
+        typename std::aligned_storage<sizeof(Value), alignof(Value)>::type storage;
+        size_t height;
+        //实际分配height个，节点按高度分配不同大小的内存
+        std::atomic<skip_node*> next[1];
+
+        Value* value() { return reinterpret_cast<Value*>(&storage); }
+        static size_t bytes(size_t h) { return sizeof(skip_node) + (h - 1) * sizeof(std::atomic<skip_node*>); }
+    };
+
+    //只能向前遍历，end()为空指针
+    template <typename Value, typename Ref, typename Ptr>
+    struct skip_list_iterator{
+        using iterator_category = forward_iterator_tag;
+        using value_type        = Value;
+        using difference_type   = ptrdiff_t;
+        using reference         = Ref;
+        using pointer           = Ptr;
+        using self              = skip_list_iterator;
+        using node_pointer      = skip_node<Value>*;
+
+        node_pointer node;
+
+        skip_list_iterator() : node(nullptr) {}
+        explicit skip_list_iterator(node_pointer n) : node(n) {}
+        //iterator可以转换为const_iterator
+        template <typename R, typename P>
+        skip_list_iterator(const skip_list_iterator<Value, R, P>& it) : node(it.node) {}
+
+        reference operator*() const { return *node->value(); }
+        pointer operator->() const { return node->value(); }
+        self& operator++() { node = node->next[0].load(std::memory_order_acquire); return *this; }
+        self operator++(int) { self tmp = *this; ++*this; return tmp; }
+
+        bool operator==(const self& rhs) const { return node == rhs.node; }
+        bool operator!=(const self& rhs) const { return node != rhs.node; }
+    };
+
+    template <typename Key, typename T, typename Compare = std::less<Key>, bool ConcurrentRead = false>
+    class skip_list{
+    public:
+        using key_type = Key;
+        using mapped_type = T;
+        using value_type = std::pair<const Key, T>;
+        using key_compare = Compare;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using iterator = skip_list_iterator<value_type, value_type&, value_type*>;
+        using const_iterator = skip_list_iterator<value_type, const value_type&, const value_type*>;
+
+    protected:
+        using node_type = skip_node<value_type>;
+        using node_pointer = node_type*;
+        //第i层的节点数约为n / 4^i，16层足够放下40亿个元素
+        enum { max_level = 16 };
+
+        //头节点有max_level层，不保存元素
+        node_pointer head;
+        std::atomic<size_type> level;
+        std::atomic<size_type> len;
+        Compare comp;
+        uint32_t seed;
+        //ConcurrentRead时被erase摘下、等待reclaim释放的节点
+        vector<node_pointer> retired;
+
+        static node_pointer allocate_node(size_type h) {
+            node_pointer p = static_cast<node_pointer>(default_alloc::allocate(node_type::bytes(h)));
+            p->height = h;
+            for (size_type i = 0; i < h; ++i)
+                ::new (static_cast<void*>(&p->next[i])) std::atomic<node_pointer>(nullptr);
+            return p;
+        }
+        static void deallocate_node(node_pointer p) {
+            default_alloc::deallocate(p, node_type::bytes(p->height));
+        }
+        static void destroy_node(node_pointer p) {
+            MyStl::destroy(p->value());
+            deallocate_node(p);
+        }
+        static node_pointer next_of(node_pointer p, size_type i) {
+            return p->next[i].load(std::memory_order_acquire);
+        }
+        const Key& key_of(node_pointer p) const { return p->value()->first; }
+        //每层以1/4的概率长高
+        size_type random_height() {
+            size_type h = 1;
+            while (h < max_level) {
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+                if (seed & 3)
+                    break;
+                ++h;
+            }
+            return h;
+        }
+        //返回第一个不小于key的节点，prev不为空时记下每一层最后一个小于key的节点
+        node_pointer find_greater_or_equal(const Key& key, node_pointer* prev) const;
+        void free_all();
+
+    public:
+        /*构造与析构*/
+        explicit skip_list(const Compare& c = Compare())
+                : head(allocate_node(max_level)), level(1), len(0), comp(c), seed(0x9E3779B9u) {}
+        //委托的构造函数完成后对象已经构造完毕，函数体抛出异常时由析构函数释放已插入的节点
+        skip_list(std::initializer_list<value_type> il, const Compare& c = Compare()) : skip_list(c) {
+            for (const value_type& v : il)
+                insert(v.first, v.second);
+        }
+        skip_list(const skip_list& rhs) : skip_list(rhs.comp) {
+            for (const_iterator it = rhs.begin(); it != rhs.end(); ++it)
+                insert(it->first, it->second);
+        }
+        skip_list& operator=(const skip_list& rhs) {
+            if (&rhs != this) {
+                skip_list temp(rhs);
+                swap(temp);
+            }
+            return *this;
+        }
+        ~skip_list() { free_all(); }
+
+        //迭代器
+        iterator begin() { return iterator(next_of(head, 0)); }
+        iterator end() { return iterator(); }
+        const_iterator begin() const { return const_iterator(next_of(head, 0)); }
+        const_iterator end() const { return const_iterator(); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+        //容量
+        size_type size() const { return len.load(std::memory_order_relaxed); }
+        bool empty() const { return size() == 0; }
+
+        //查找，可以和一个写线程并发调用
+        iterator find(const Key& key) {
+            node_pointer p = find_greater_or_equal(key, nullptr);
+            return iterator(p && !comp(key, key_of(p)) ? p : nullptr);
+        }
+        const_iterator find(const Key& key) const { return const_cast<skip_list*>(this)->find(key); }
+        bool contains(const Key& key) const { return find(key) != end(); }
+        //第一个不小于key的元素
+        iterator lower_bound(const Key& key) { return iterator(find_greater_or_equal(key, nullptr)); }
+        const_iterator lower_bound(const Key& key) const { return const_iterator(find_greater_or_equal(key, nullptr)); }
+
+        //修改器，调用者需要保证同一时间只有一个线程修改
+        //key已存在时不插入，返回已有的元素和false
+        template <typename... Args>
+        std::pair<iterator, bool> emplace(const Key& key, Args&&... args);
+        std::pair<iterator, bool> insert(const Key& key, const T& value) { return emplace(key, value); }
+        std::pair<iterator, bool> insert(const Key& key, T&& value) { return emplace(key, MyStl::move(value)); }
+        std::pair<iterator, bool> insert(const value_type& value) { return emplace(value.first, value.second); }
+        //删除key，返回删除的个数
+        size_type erase(const Key& key);
+        //删除pos处的元素，返回下一个元素
+        iterator erase(iterator pos) {
+            iterator next = pos;
+            ++next;
+            erase(pos->first);
+            return next;
+        }
+        //释放被erase摘下的节点，调用时不能有并发的读者
+        void reclaim() {
+            for (size_type i = 0; i < retired.size(); ++i)
+                destroy_node(retired[i]);
+            retired.clear();
+        }
+        //不能和读者并发调用
+        void clear() {
+            node_pointer p = next_of(head, 0);
+            while (p) {
+                node_pointer next = next_of(p, 0);
+                destroy_node(p);
+                p = next;
+            }
+            for (size_type i = 0; i < max_level; ++i)
+                head->next[i].store(nullptr, std::memory_order_relaxed);
+            level.store(1, std::memory_order_relaxed);
+            len.store(0, std::memory_order_relaxed);
+            reclaim();
+        }
+        void swap(skip_list& rhs) {
+            std::swap(head, rhs.head);
+            const size_type l = level.load(std::memory_order_relaxed);
+            level.store(rhs.level.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            rhs.level.store(l, std::memory_order_relaxed);
+            const size_type n = len.load(std::memory_order_relaxed);
+            len.store(rhs.len.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            rhs.len.store(n, std::memory_order_relaxed);
+            std::swap(comp, rhs.comp);
+            std::swap(seed, rhs.seed);
+            retired.swap(rhs.retired);
+        }
+    };
+
+    template <typename Key, typename T, typename Compare, bool ConcurrentRead>
+    typename skip_list<Key, T, Compare, ConcurrentRead>::node_pointer
+    skip_list<Key, T, Compare, ConcurrentRead>::find_greater_or_equal(const Key& key, node_pointer* prev) const {
+        node_pointer x = head;
+        size_type i = level.load(std::memory_order_acquire) - 1;
+        for (;;) {
+            node_pointer next = next_of(x, i);
+            if (next && comp(key_of(next), key)) {
+                //在这一层继续向右
+                x = next;
+            } else {
+                if (prev)
+                    prev[i] = x;
+                if (i == 0)
+                    return next;
+                --i;
+            }
+        }
+    }
+
+    template <typename Key, typename T, typename Compare, bool ConcurrentRead>
+    template <typename... Args>
+    std::pair<typename skip_list<Key, T, Compare, ConcurrentRead>::iterator, bool>
+    skip_list<Key, T, Compare, ConcurrentRead>::emplace(const Key& key, Args&&... args) {
+        node_pointer prev[max_level];
+        node_pointer x = find_greater_or_equal(key, prev);
+        if (x && !comp(key, key_of(x)))
+            return std::make_pair(iterator(x), false);
+        const size_type h = random_height();
+        const size_type old_level = level.load(std::memory_order_relaxed);
+        for (size_type i = old_level; i < h; ++i)
+            prev[i] = head;
+        node_pointer p = allocate_node(h);
+        try {
+            ::new (static_cast<void*>(p->value())) value_type(std::piecewise_construct,
+                                                              std::forward_as_tuple(key),
+                                                              std::forward_as_tuple(MyStl::forward<Args>(args)...));
+        } catch (...) {
+            deallocate_node(p);
+            throw;
+        }
+        //读者看到更高的level时，头节点在这些层上要么为空，要么已经指向完整的新节点
+        if (h > old_level)
+            level.store(h, std::memory_order_release);
+        //从底层向上发布，先填好新节点自己的next，再让前驱指向它
+        for (size_type i = 0; i < h; ++i) {
+            p->next[i].store(prev[i]->next[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            prev[i]->next[i].store(p, std::memory_order_release);
+        }
+        len.fetch_add(1, std::memory_order_relaxed);
+        return std::make_pair(iterator(p), true);
+    }
+
+    template <typename Key, typename T, typename Compare, bool ConcurrentRead>
+    typename skip_list<Key, T, Compare, ConcurrentRead>::size_type
+    skip_list<Key, T, Compare, ConcurrentRead>::erase(const Key& key) {
+        node_pointer prev[max_level];
+        node_pointer x = find_greater_or_equal(key, prev);
+        if (!x || comp(key, key_of(x)))
+            return 0;
+        //摘除之后push_back不能再失败，否则节点既不在表中也不在retired中，所以先预留空间
+        if (ConcurrentRead && retired.size() == retired.capacity())
+            retired.reserve(retired.empty() ? 8 : 2 * retired.size());
+        //从顶层向下摘除，x自己的next保持不变，正停在x上的读者仍能继续向后走
+        for (size_type i = x->height; i-- > 0; )
+            if (prev[i]->next[i].load(std::memory_order_relaxed) == x)
+                prev[i]->next[i].store(x->next[i].load(std::memory_order_relaxed), std::memory_order_release);
+        size_type l = level.load(std::memory_order_relaxed);
+        while (l > 1 && !head->next[l - 1].load(std::memory_order_relaxed))
+            --l;
+        level.store(l, std::memory_order_release);
+        len.fetch_sub(1, std::memory_order_relaxed);
+        if (ConcurrentRead)
+            retired.push_back(x);
+        else
+            destroy_node(x);
+        return 1;
+    }
+
+    template <typename Key, typename T, typename Compare, bool ConcurrentRead>
+    void skip_list<Key, T, Compare, ConcurrentRead>::free_all() {
+        clear();
+        deallocate_node(head);
+    }
+}
+
+#endif //MYSTL_SKIP_LIST_H
@@ -0,0 +1,101 @@
+
+#ifndef MYSTL_SNAPSHOT_H
+#define MYSTL_SNAPSHOT_H
+
+//容器二进制快照的公共部分，供vector和deque的save/load使用
+//快照格式 = snapshot_header + 原始元素数据，元素必须可平凡拷贝，不做逐元素的序列化
+#include <system_error>
+#include <stdexcept>
+#include <cerrno>
+#include <cstdint>
+#include <climits>
+#include <unistd.h>
+#include <sys/uio.h>
+
+namespace MyStl{
+    struct snapshot_header{
+        uint64_t magic;
+        uint64_t elem_size;
+        uint64_t count;
+    };
+
+    enum : uint64_t { snapshot_magic = 0x4D5953544E415031ULL };   //"MYSTNAP1"
+
+    //单次readv/writev能提交的iovec个数上限
+#ifdef IOV_MAX
+    enum { snapshot_iov_max = IOV_MAX };
+#else
+    enum { snapshot_iov_max = 1024 };
+#endif
+
+    inline void snapshot_throw_errno(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    //writev/readv可能只完成一部分，需要跳过已经完成的iovec并继续
+    inline void snapshot_advance(iovec*& iov, int& cnt, size_t done) {
+        while (cnt > 0 && done >= iov->iov_len) {
+            done -= iov->iov_len;
+            ++iov;
+            --cnt;
+        }
+        if (cnt > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + done;
+            iov->iov_len -= done;
+        }
+    }
+
+    inline void snapshot_writev(int fd, iovec* iov, int cnt) {
+        snapshot_advance(iov, cnt, 0);   //跳过长度为0的iovec
+        while (cnt > 0) {
+            ssize_t n = ::writev(fd, iov, cnt);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                snapshot_throw_errno("snapshot: writev");
+            }
+            snapshot_advance(iov, cnt, size_t(n));
+        }
+    }
+
+    inline void snapshot_readv(int fd, iovec* iov, int cnt) {
+        snapshot_advance(iov, cnt, 0);   //跳过长度为0的iovec
+        while (cnt > 0) {
+            ssize_t n = ::readv(fd, iov, cnt);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                snapshot_throw_errno("snapshot: readv");
+            }
+            if (n == 0)
+                throw std::runtime_error("snapshot: unexpected end of file");
+            snapshot_advance(iov, cnt, size_t(n));
+        }
+    }
+
+    inline void snapshot_write(int fd, const void* buf, size_t len) {
+        iovec iov = {const_cast<void*>(buf), len};
+        snapshot_writev(fd, &iov, 1);
+    }
+
+    inline void snapshot_read(int fd, void* buf, size_t len) {
+        iovec iov = {buf, len};
+        snapshot_readv(fd, &iov, 1);
+    }
+
+    inline void snapshot_write_header(int fd, size_t elem_size, size_t count) {
+        snapshot_header h = {snapshot_magic, elem_size, count};
+        snapshot_write(fd, &h, sizeof(h));
+    }
+
+    //读取并检查文件头，返回元素个数
+    inline size_t snapshot_read_header(int fd, size_t elem_size) {
+        snapshot_header h;
+        snapshot_read(fd, &h, sizeof(h));
+        if (h.magic != snapshot_magic || h.elem_size != elem_size)
+            throw std::runtime_error("snapshot: header does not match element type");
+        return size_t(h.count);
+    }
+}
+
+#endif //MYSTL_SNAPSHOT_H
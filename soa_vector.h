@@ -0,0 +1,333 @@
+
+#ifndef MYSTL_SOA_VECTOR_H
+#define MYSTL_SOA_VECTOR_H
+
+#include <tuple>
+#include "pool_allocator.h"
+#include "iterator.h"
+#include "construct.h"
+#include "uninitialized.h"
+
+namespace MyStl{
+    //soa_vector 即 structure of arrays
+    //vector<Record>把一条记录的所有字段放在一起(AoS)，而soa_vector把每个字段单独存放在一块连续内存中
+    //只扫描少数几个字段时，缓存行里全是有用的数据，编译器也更容易向量化
+    //所有列共享同一个size/capacity，使用与vector相同的增长策略，内存统一由pool_alloc分配
+
+    //某一列的视图，不拥有内存
+    template <typename T>
+    struct span{
+        using value_type = T;
+        using iterator = T*;
+        using size_type = size_t;
+
+        T* ptr;
+        size_type len;
+
+        span() : ptr(nullptr), len(0) {}
+        span(T* p, size_type n) : ptr(p), len(n) {}
+
+        iterator begin() const { return ptr; }
+        iterator end() const { return ptr + len; }
+        T* data() const { return ptr; }
+        size_type size() const { return len; }
+        bool empty() const { return len == 0; }
+        T& operator[](size_type n) const { return ptr[n]; }
+    };
+
+    template <typename Soa, typename Ref>
+    struct soa_iterator;
+
+    template <typename... Ts>
+    class soa_vector{
+    public:
+        using size_type         = size_t;
+        using difference_type   = ptrdiff_t;
+        using value_type        = std::tuple<Ts...>;
+        //行的代理引用，通过std::get<I>访问各个字段
+        using reference         = std::tuple<Ts&...>;
+        using const_reference   = std::tuple<const Ts&...>;
+        using iterator          = soa_iterator<soa_vector, reference>;
+        using const_iterator    = soa_iterator<const soa_vector, const_reference>;
+
+        //第I列的元素类型
+        template <size_t I>
+        using column_type = typename std::tuple_element<I, value_type>::type;
+
+        enum { columns = sizeof...(Ts) };
+
+    protected:
+        using pointers = std::tuple<Ts*...>;
+        using indices = make_index_sequence<sizeof...(Ts)>;
+        //用于在初始化列表中按顺序展开参数包
+        using swallow = int[];
+
+        pointers cols;
+        size_type len;
+        size_type cap;
+
+        /*内调函数，每个函数都会对所有列执行同样的操作*/
+        //为每一列分配n个元素的内存
+        template <size_t... Is>
+        static pointers allocate_columns(size_type n, index_sequence<Is...>);
+        template <size_t... Is>
+        static void deallocate_columns(pointers& p, size_type n, index_sequence<Is...>);
+        //析构前count列的[first, last)，用于异常时回滚
+        template <size_t... Is>
+        static void destroy_columns(pointers& p, size_type first, size_type last,
+                                    size_type count, index_sequence<Is...>);
+        //将当前的[0, len)拷贝构造到to中
+        template <size_t... Is>
+        void copy_columns(pointers& to, index_sequence<Is...>) const;
+        //在pos处构造一行
+        template <size_t... Is>
+        void construct_row(size_type pos, index_sequence<Is...>, const Ts&... values);
+        //在[len, n)处默认构造
+        template <size_t... Is>
+        void fill_default(size_type n, index_sequence<Is...>);
+        template <size_t... Is>
+        reference row(size_type n, index_sequence<Is...>) {
+            return reference(std::get<Is>(cols)[n]...);
+        }
+        template <size_t... Is>
+        const_reference row(size_type n, index_sequence<Is...>) const {
+            return const_reference(std::get<Is>(cols)[n]...);
+        }
+        //重新分配内存，容量变为new_cap
+        void reallocate(size_type new_cap);
+        //与vector相同的增长策略
+        size_type next_capacity() const { return len == 0 ? 10 : 2 * len; }
+
+    public:
+        //构造与析构
+        soa_vector() : cols(), len(0), cap(0) {}
+        explicit soa_vector(size_type n) : cols(), len(0), cap(0) { resize(n); }
+        soa_vector(const soa_vector& rhs);
+        soa_vector& operator=(const soa_vector& rhs);
+        ~soa_vector() {
+            clear();
+            deallocate_columns(cols, cap, indices());
+        }
+
+        //元素访问
+        reference operator[](size_type n) { return row(n, indices()); }
+        const_reference operator[](size_type n) const { return row(n, indices()); }
+        reference front() { return (*this)[0]; }
+        const_reference front() const { return (*this)[0]; }
+        reference back() { return (*this)[len - 1]; }
+        const_reference back() const { return (*this)[len - 1]; }
+
+        //按列访问，返回第I列的连续内存
+        template <size_t I>
+        column_type<I>* data() { return std::get<I>(cols); }
+        template <size_t I>
+        const column_type<I>* data() const { return std::get<I>(cols); }
+        template <size_t I>
+        span<column_type<I>> column() { return span<column_type<I>>(std::get<I>(cols), len); }
+        template <size_t I>
+        span<const column_type<I>> column() const {
+            return span<const column_type<I>>(std::get<I>(cols), len);
+        }
+
+        //迭代器
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, len); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, len); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+        //容量
+        size_type size() const { return len; }
+        size_type capacity() const { return cap; }
+        bool empty() const { return len == 0; }
+        void reserve(size_type new_cap) {
+            if (new_cap > cap)
+                reallocate(new_cap);
+        }
+
+        //修改器
+        void push_back(const Ts&... values);
+        void pop_back() {
+            --len;
+            destroy_columns(cols, len, len + 1, columns, indices());
+        }
+        void resize(size_type n);
+        void clear() {
+            destroy_columns(cols, 0, len, columns, indices());
+            len = 0;
+        }
+        void swap(soa_vector& rhs) {
+            std::swap(cols, rhs.cols);
+            std::swap(len, rhs.len);
+            std::swap(cap, rhs.cap);
+        }
+    };
+
+    template <typename... Ts>
+    template <size_t... Is>
+    typename soa_vector<Ts...>::pointers
+    soa_vector<Ts...>::allocate_columns(size_type n, index_sequence<Is...>) {
+        pointers p;
+        try {
+            (void)swallow{0, (std::get<Is>(p) = pool_alloc<Ts>::allocate(n), 0)...};
+        } catch (...) {
+            deallocate_columns(p, n, indices());
+            throw;
+        }
+        return p;
+    }
+
+    template <typename... Ts>
+    template <size_t... Is>
+    void soa_vector<Ts...>::deallocate_columns(pointers& p, size_type n, index_sequence<Is...>) {
+        //pool_alloc会把空指针也放回内存池，所以要先判断
+        (void)swallow{0, (std::get<Is>(p) ? pool_alloc<Ts>::deallocate(std::get<Is>(p), n) : void(), 0)...};
+        p = pointers();
+    }
+
+    template <typename... Ts>
+    template <size_t... Is>
+    void soa_vector<Ts...>::destroy_columns(pointers& p, size_type first, size_type last,
+                                            size_type count, index_sequence<Is...>) {
+        (void)swallow{0, (Is < count ? MyStl::destroy(std::get<Is>(p) + first, std::get<Is>(p) + last) : void(), 0)...};
+    }
+
+    template <typename... Ts>
+    template <size_t... Is>
+    void soa_vector<Ts...>::copy_columns(pointers& to, index_sequence<Is...>) const {
+        //uninitialized_copy负责析构出错的那一列，这里只需要析构之前已经拷贝好的列
+        size_type done = 0;
+        try {
+            (void)swallow{0, (MyStl::uninitialized_copy(std::get<Is>(cols), std::get<Is>(cols) + len,
+                                                        std::get<Is>(to)), ++done, 0)...};
+        } catch (...) {
+            destroy_columns(to, 0, len, done, indices());
+            throw;
+        }
+    }
+
+    template <typename... Ts>
+    template <size_t... Is>
+    void soa_vector<Ts...>::construct_row(size_type pos, index_sequence<Is...>, const Ts&... values) {
+        size_type done = 0;
+        try {
+            (void)swallow{0, (MyStl::construct(std::get<Is>(cols) + pos, values), ++done, 0)...};
+        } catch (...) {
+            destroy_columns(cols, pos, pos + 1, done, indices());
+            throw;
+        }
+    }
+
+    template <typename... Ts>
+    template <size_t... Is>
+    void soa_vector<Ts...>::fill_default(size_type n, index_sequence<Is...>) {
+        size_type done = 0;
+        try {
+            (void)swallow{0, (MyStl::uninitialized_fill_n(std::get<Is>(cols) + len, n - len, Ts()), ++done, 0)...};
+        } catch (...) {
+            destroy_columns(cols, len, n, done, indices());
+            throw;
+        }
+    }
+
+    template <typename... Ts>
+    void soa_vector<Ts...>::reallocate(size_type new_cap) {
+        pointers new_cols = allocate_columns(new_cap, indices());
+        try {
+            copy_columns(new_cols, indices());
+        } catch (...) {
+            deallocate_columns(new_cols, new_cap, indices());
+            throw;
+        }
+        destroy_columns(cols, 0, len, columns, indices());
+        deallocate_columns(cols, cap, indices());
+        cols = new_cols;
+        cap = new_cap;
+    }
+
+    template <typename... Ts>
+    soa_vector<Ts...>::soa_vector(const soa_vector& rhs) : cols(), len(0), cap(0) {
+        if (rhs.len == 0)
+            return;
+        pointers new_cols = allocate_columns(rhs.len, indices());
+        try {
+            rhs.copy_columns(new_cols, indices());
+        } catch (...) {
+            deallocate_columns(new_cols, rhs.len, indices());
+            throw;
+        }
+        cols = new_cols;
+        len = cap = rhs.len;
+    }
+
+    //使用swap局部临时变量的方法，和vector的initializer_list赋值一致
+    template <typename... Ts>
+    soa_vector<Ts...>& soa_vector<Ts...>::operator=(const soa_vector& rhs) {
+        if (&rhs != this) {
+            soa_vector temp(rhs);
+            swap(temp);
+        }
+        return *this;
+    }
+
+    template <typename... Ts>
+    void soa_vector<Ts...>::push_back(const Ts&... values) {
+        if (len == cap)
+            reallocate(next_capacity());
+        construct_row(len, indices(), values...);
+        ++len;
+    }
+
+    template <typename... Ts>
+    void soa_vector<Ts...>::resize(size_type n) {
+        if (n < len) {
+            destroy_columns(cols, n, len, columns, indices());
+        } else if (n > len) {
+            reserve(n);
+            fill_default(n, indices());
+        }
+        len = n;
+    }
+
+    //行迭代器，只保存容器指针和下标，解引用时返回代理引用
+    template <typename Soa, typename Ref>
+    struct soa_iterator{
+        using iterator_category = random_access_iterator_tag;
+        using value_type        = typename remove_const_t<Soa>::value_type;
+        using difference_type   = ptrdiff_t;
+        using reference         = Ref;
+        using pointer           = void;
+        using self              = soa_iterator;
+
+        Soa* soa;
+        size_t index;
+
+        soa_iterator() : soa(nullptr), index(0) {}
+        soa_iterator(Soa* s, size_t n) : soa(s), index(n) {}
+        //iterator可以转换为const_iterator
+        template <typename S, typename R>
+        soa_iterator(const soa_iterator<S, R>& it) : soa(it.soa), index(it.index) {}
+
+        reference operator*() const { return (*soa)[index]; }
+        reference operator[](difference_type n) const { return (*soa)[index + n]; }
+
+        self& operator++() { ++index; return *this; }
+        self operator++(int) { self tmp = *this; ++index; return tmp; }
+        self& operator--() { --index; return *this; }
+        self operator--(int) { self tmp = *this; --index; return tmp; }
+        self& operator+=(difference_type n) { index += n; return *this; }
+        self& operator-=(difference_type n) { index -= n; return *this; }
+        self operator+(difference_type n) const { return self(soa, index + n); }
+        self operator-(difference_type n) const { return self(soa, index - n); }
+        difference_type operator-(const self& rhs) const {
+            return difference_type(index) - difference_type(rhs.index);
+        }
+
+        bool operator==(const self& rhs) const { return index == rhs.index; }
+        bool operator!=(const self& rhs) const { return index != rhs.index; }
+        bool operator<(const self& rhs) const { return index < rhs.index; }
+    };
+}
+
+#endif //MYSTL_SOA_VECTOR_H
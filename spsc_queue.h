@@ -0,0 +1,189 @@
+
+#ifndef MYSTL_SPSC_QUEUE_H
+#define MYSTL_SPSC_QUEUE_H
+
+//单生产者单消费者的无锁环形队列，容量固定为2的幂
+//生产者只写tail，消费者只写head，两者通过acquire/release同步，不需要互斥锁
+//head和tail放在不同的缓存行中，各自还缓存一份对方的下标，只有看起来满/空时才去读对方的原子变量
+//接口与queue保持一致(push/pop/front/size/empty)，另外提供不阻塞的try_push/try_pop和批量的try_push_n/try_pop_n
+#include <atomic>
+#include <thread>
+#include "pool_allocator.h"
+#include "construct.h"
+#include "move.h"
+
+namespace MyStl{
+    template <typename T>
+    class spsc_queue{
+    public:
+        using value_type = T;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = size_t;
+
+    protected:
+        using data_alloc = pool_alloc<value_type>;
+        enum { cache_line = 64 };
+
+        //只读部分
+        T* buf;
+        size_type cap;
+        size_type mask;
+        char pad0[cache_line];
+        //消费者使用的部分
+        std::atomic<size_type> head;
+        size_type cached_tail;
+        char pad1[cache_line];
+        //生产者使用的部分
+        std::atomic<size_type> tail;
+        size_type cached_head;
+        char pad2[cache_line];
+
+        static size_type round_up(size_type n) {
+            size_type r = 1;
+            while (r < n)
+                r <<= 1;
+            return r;
+        }
+        //生产者：可写入的空位数，不足want时重新读取head
+        size_type free_slots(size_type t, size_type want) {
+            if (cap - (t - cached_head) < want)
+                cached_head = head.load(std::memory_order_acquire);
+            return cap - (t - cached_head);
+        }
+        //消费者：可读取的元素数，不足want时重新读取tail
+        size_type ready_slots(size_type h, size_type want) {
+            if (cached_tail - h < want)
+                cached_tail = tail.load(std::memory_order_acquire);
+            return cached_tail - h;
+        }
+
+    public:
+        //容量会向上取整到2的幂
+        explicit spsc_queue(size_type capacity)
+                : buf(nullptr), cap(round_up(capacity ? capacity : 1)), mask(cap - 1),
+                  head(0), cached_tail(0), tail(0), cached_head(0) {
+            buf = data_alloc::allocate(cap);
+        }
+        spsc_queue(const spsc_queue&) = delete;
+        spsc_queue& operator=(const spsc_queue&) = delete;
+        ~spsc_queue() {
+            for (size_type i = head.load(std::memory_order_relaxed); i != tail.load(std::memory_order_relaxed); ++i)
+                MyStl::destroy(buf + (i & mask));
+            data_alloc::deallocate(buf, cap);
+        }
+
+        /*生产者接口*/
+        bool try_push(const value_type& value) {
+            const size_type t = tail.load(std::memory_order_relaxed);
+            if (free_slots(t, 1) == 0)
+                return false;
+            MyStl::construct(buf + (t & mask), value);
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+        //右值版本直接移动进槽位，大消息不需要深拷贝；队列满时value保持不变
+        bool try_push(value_type&& value) {
+            const size_type t = tail.load(std::memory_order_relaxed);
+            if (free_slots(t, 1) == 0)
+                return false;
+            MyStl::construct(buf + (t & mask), MyStl::move(value));
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+        //从first开始最多写入n个元素，返回实际写入的个数，整批只发布一次tail
+        template <typename InputIterator>
+        size_type try_push_n(InputIterator first, size_type n);
+        //队列满时自旋等待
+        void push(const value_type& value) {
+            while (!try_push(value))
+                std::this_thread::yield();
+        }
+        void push(value_type&& value) {
+            while (!try_push(MyStl::move(value)))
+                std::this_thread::yield();
+        }
+
+        /*消费者接口*/
+        bool try_pop(value_type& value) {
+            const size_type h = head.load(std::memory_order_relaxed);
+            if (ready_slots(h, 1) == 0)
+                return false;
+            T* p = buf + (h & mask);
+            //槽位中的元素马上析构，直接移动出去
+            value = MyStl::move(*p);
+            MyStl::destroy(p);
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+        //最多读取n个元素写入result，返回实际读取的个数
+        template <typename OutputIterator>
+        size_type try_pop_n(OutputIterator result, size_type n);
+        //与queue相同，front和pop只能由消费者调用，调用前队列不能为空
+        //ready_slots保证读到生产者写入的元素，同时让cached_tail不落后于head
+        reference front() {
+            const size_type h = head.load(std::memory_order_relaxed);
+            ready_slots(h, 1);
+            return buf[h & mask];
+        }
+        void pop() {
+            const size_type h = head.load(std::memory_order_relaxed);
+            ready_slots(h, 1);
+            MyStl::destroy(buf + (h & mask));
+            head.store(h + 1, std::memory_order_release);
+        }
+
+        //容量，其他线程同时修改时size只是近似值
+        size_type size() const {
+            return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+        }
+        bool empty() const { return size() == 0; }
+        size_type capacity() const { return cap; }
+    };
+
+    template <typename T>
+    template <typename InputIterator>
+    typename spsc_queue<T>::size_type spsc_queue<T>::try_push_n(InputIterator first, size_type n) {
+        const size_type t = tail.load(std::memory_order_relaxed);
+        const size_type avail = free_slots(t, n);
+        if (n > avail)
+            n = avail;
+        size_type i = 0;
+        try {
+            for (; i < n; ++i, ++first)
+                MyStl::construct(buf + ((t + i) & mask), *first);
+        } catch (...) {
+            //还没有发布，析构已经构造的元素即可
+            for (size_type j = 0; j < i; ++j)
+                MyStl::destroy(buf + ((t + j) & mask));
+            throw;
+        }
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    template <typename T>
+    template <typename OutputIterator>
+    typename spsc_queue<T>::size_type spsc_queue<T>::try_pop_n(OutputIterator result, size_type n) {
+        const size_type h = head.load(std::memory_order_relaxed);
+        const size_type avail = ready_slots(h, n);
+        if (n > avail)
+            n = avail;
+        size_type i = 0;
+        try {
+            for (; i < n; ++i, ++result) {
+                T* p = buf + ((h + i) & mask);
+                *result = MyStl::move(*p);
+                MyStl::destroy(p);
+            }
+        } catch (...) {
+            //已经取出的元素要发布出去，出错的元素仍留在队列中
+            head.store(h + i, std::memory_order_release);
+            throw;
+        }
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+}
+
+#endif //MYSTL_SPSC_QUEUE_H
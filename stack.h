@@ -31,6 +31,9 @@ namespace MyStl{
         bool empty() const { return con.empty(); }
         size_type size() const { return con.size(); }
         void push(const value_type& value) { con.push_back(value); }
+        void push(value_type&& value) { con.push_back(MyStl::move(value)); }
+        template <typename... Args>
+        void emplace(Args&&... args) { con.emplace_back(MyStl::forward<Args>(args)...); }
         void pop() { con.pop_back(); }
     };
 
@@ -64,6 +67,9 @@ namespace MyStl{
         return !(lhs < rhs);
     }
 
+    //底层使用BufSiz个元素的缓冲区的deque，例如block_stack<int, 1024>使用4KB的缓冲区
+    template <typename T, size_t BufSiz>
+    using block_stack = stack<T, MyStl::deque<T, BufSiz>>;
 
 }
 
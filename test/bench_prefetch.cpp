@@ -0,0 +1,51 @@
+
+//deque分段算法中预取下一个缓冲区的效果
+//同一份源码编译两次：bench_prefetch使用预取，bench_prefetch_off定义了MYSTL_NO_PREFETCH，对比两者的输出
+#include <iostream>
+#include <ctime>
+#include <random>
+#include <vector>
+#include "../deque.h"
+
+//读一遍比缓存大得多的内存，把deque的缓冲区挤出缓存
+static void evict_cache() {
+    static std::vector<char> junk(64 << 20);
+    for (size_t i = 0; i < junk.size(); i += 64)
+        ++junk[i];
+}
+
+int main() {
+#ifdef MYSTL_NO_PREFETCH
+    std::cout << "[------------------- prefetch disabled -------------------]\n";
+#else
+    std::cout << "[------------------- prefetch enabled --------------------]\n";
+#endif
+    //随机地向多个deque尾部插入，每个deque相邻的缓冲区在内存中不相邻
+    const int k = 64, n = 8000000;
+    std::vector<MyStl::deque<long>> ds(k);
+    std::mt19937 rng(1);
+    for (int i = 0; i < n; ++i)
+        ds[rng() % k].push_back(i);
+
+    const int rounds = 5;
+    clock_t for_each_ticks = 0, find_ticks = 0;
+    long sum = 0;
+    for (int r = 0; r < rounds; ++r) {
+        evict_cache();
+        clock_t start = clock();
+        for (auto& d : ds)
+            MyStl::for_each(d.begin(), d.end(), [&sum](long x) { sum += x; });
+        for_each_ticks += clock() - start;
+        evict_cache();
+        start = clock();
+        for (auto& d : ds)
+            sum += MyStl::find(d.begin(), d.end(), -1L) == d.end();
+        find_ticks += clock() - start;
+    }
+    std::cout << " for_each " << n << " longs, cold : "
+              << for_each_ticks * 1000 / CLOCKS_PER_SEC / rounds << " ms\n";
+    std::cout << " find " << n << " longs, cold : "
+              << find_ticks * 1000 / CLOCKS_PER_SEC / rounds << " ms\n";
+    std::cout << " checksum : " << sum << "\n";
+    return 0;
+}
@@ -0,0 +1,98 @@
+
+#ifndef MYSTL_TEST_COMPACT_LIST_H
+#define MYSTL_TEST_COMPACT_LIST_H
+#include <iostream>
+#include <string>
+#include <ctime>
+#include "test_Macros.h"
+#include "../compact_list.h"
+#include "../list.h"
+namespace MyStl{
+    void test_compact_list() {
+        std::cout << "[============================================================"
+                     "===]\n";
+        std::cout << "[----------------- Run container test : compact_list "
+                     "-------------------]\n";
+        std::cout << "[-------------------------- API test "
+                     "---------------------------]\n";
+        MyStl::compact_list<int> c1;
+        MyStl::compact_list<int> c2 = {1, 2, 3, 4, 5};
+        MyStl::compact_list<int> c3(c2);
+        MyStl::compact_list<int> c4(3, 7);
+        PRINT(c2);
+        PRINT(c3);
+        PRINT(c4);
+        FUN_VALUE(MyStl::compact_list<int>::node_bytes());
+        FUN_VALUE(sizeof(MyStl::list_node<int>));
+        FUN_AFTER(c2, c2.push_front(0));
+        FUN_AFTER(c2, c2.push_back(6));
+        FUN_AFTER(c2, c2.pop_front());
+        FUN_AFTER(c2, c2.pop_back());
+        FUN_AFTER(c2, c2.erase(++c2.begin()));
+        FUN_AFTER(c2, c2.insert(c2.end(), c2.front()));
+        FUN_VALUE(c2.front());
+        FUN_VALUE(c2.back());
+        FUN_VALUE(*c2.rbegin());
+        //删除的节点被复用，容量不变
+        MyStl::size_t cap = c2.capacity();
+        for (int i = 0; i < 100; ++i) {
+            c2.push_back(i);
+            c2.pop_back();
+        }
+        FUN_VALUE((c2.capacity() == cap));
+        //迭代器保存下标，扩容后仍然有效
+        MyStl::compact_list<std::string> c5 = {"a", "b", "c"};
+        auto it = ++c5.begin();
+        for (int i = 0; i < 100; ++i)
+            c5.push_back(*it);
+        FUN_VALUE(*it);
+        FUN_VALUE(c5.size());
+        FUN_AFTER(c5, c5.erase(++c5.begin(), c5.end()));
+        MyStl::compact_list<std::string> c6(c5);
+        FUN_VALUE((c6 == c5));
+        c3 = c2;
+        FUN_VALUE((c3 == c2));
+        FUN_AFTER(c3, c3.swap(c1));
+        FUN_AFTER(c1, c1.clear());
+        FUN_VALUE(c1.empty());
+        std::cout << "[----------------------- end API test "
+                     "---------------------------]\n";
+
+        std::cout << "[--------------------- performance test "
+                     "------------------------]\n";
+        //交替在两端插入后遍历，list的节点分散在内存池中，compact_list的节点在一块数组中
+        const int n = 2000000;
+        MyStl::list<int> l;
+        MyStl::compact_list<int> c;
+        for (int i = 0; i < n; ++i) {
+            if (i & 1) {
+                l.push_back(i);
+                c.push_back(i);
+            } else {
+                l.push_front(i);
+                c.push_front(i);
+            }
+        }
+        long long sum1 = 0, sum2 = 0;
+        clock_t start = clock();
+        for (int r = 0; r < 10; ++r)
+            for (auto x = l.begin(); x != l.end(); ++x)
+                sum1 += *x;
+        clock_t end = clock();
+        std::cout << " list traverse " << n << " ints x10 : " << (end - start) * 1000 / CLOCKS_PER_SEC << " ms\n";
+        start = clock();
+        for (int r = 0; r < 10; ++r)
+            for (auto x = c.begin(); x != c.end(); ++x)
+                sum2 += *x;
+        end = clock();
+        std::cout << " compact_list traverse " << n << " ints x10 : " << (end - start) * 1000 / CLOCKS_PER_SEC << " ms\n";
+        start = clock();
+        MyStl::compact_list<int> copy(c);
+        end = clock();
+        std::cout << " compact_list copy " << n << " ints : " << (end - start) * 1000 / CLOCKS_PER_SEC << " ms\n";
+        FUN_VALUE((sum1 == sum2 && copy == c));
+        std::cout << "[------------------ end performance test "
+                     "-----------------------]\n";
+    }
+}
+#endif //MYSTL_TEST_COMPACT_LIST_H
@@ -2,6 +2,9 @@
 #ifndef MYSTL_TEST_DEQUE_H
 #define MYSTL_TEST_DEQUE_H
 #include <iostream>
+#include <cstdio>
+#include <memory>
+#include <string>
 #include "test_Macros.h"
 #include "../deque.h"
 namespace MyStl{
@@ -55,6 +58,105 @@ namespace MyStl{
         FUN_AFTER(d1, d1.clear());
         FUN_VALUE(d1.size());
         FUN_VALUE(d1.empty());
+        //并行初始化
+        MyStl::set_parallel_threshold(1 << 16);
+        MyStl::deque<int> d8(1 << 20, 4);
+        FUN_VALUE(d8.size());
+        FUN_VALUE(d8[(1 << 20) - 1]);
+        MyStl::set_parallel_threshold(0);
+        //快照
+        FILE* file = std::tmpfile();
+        d8.save(fileno(file));
+        d6.save(fileno(file));
+        std::rewind(file);
+        d1.load(fileno(file));
+        FUN_VALUE(d1.size());
+        FUN_VALUE(d1[(1 << 20) - 1]);
+        FUN_AFTER(d1, d1.load(fileno(file)));
+        std::fclose(file);
+        //文件头中的元素个数损坏时拒绝加载，原有内容不变
+        file = std::tmpfile();
+        MyStl::snapshot_write_header(fileno(file), sizeof(int), ~0ULL / 2);
+        std::rewind(file);
+        try {
+            d1.load(fileno(file));
+        } catch (const std::length_error& e) {
+            std::cout << " load threw: " << e.what() << "\n";
+        }
+        std::fclose(file);
+        FUN_VALUE(d1.size());
+        //编译期指定缓冲区大小，缓冲区按缓存行/页对齐
+        MyStl::deque<int, 4> d9 = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+        MyStl::deque<int, 1024> d10(3000, 7);
+        FUN_AFTER(d9, d9.insert(d9.begin() + 2, 10, 0));
+        FUN_AFTER(d9, d9.insert(d9.begin(), 5, -1));
+        FUN_VALUE(d10.size());
+        //缓冲区大小为2的幂与非2的幂时的随机访问
+        MyStl::deque<int, 3> d11(d9.begin(), d9.end());
+        FUN_VALUE(d9[13]);
+        FUN_VALUE(d11[13]);
+        FUN_VALUE((d9.begin() + 20)[-15]);
+        FUN_VALUE((d11.end() - 3)[-16]);
+        FUN_VALUE(d11.end() - (d11.begin() + 5));
+        //分段算法
+        MyStl::deque<int, 4> d12(d11.size(), 0);
+        FUN_AFTER(d12, MyStl::copy(d11.begin(), d11.end(), d12.begin()));
+        FUN_AFTER(d12, MyStl::copy_backward(d12.begin(), d12.begin() + 10, d12.end()));
+        FUN_AFTER(d12, MyStl::fill(d12.begin() + 3, d12.end() - 3, 8));
+        FUN_VALUE(MyStl::find(d11.cbegin(), d11.cend(), 3) - d11.cbegin());
+        FUN_VALUE(MyStl::accumulate(d10.begin(), d10.end(), 0L));
+        int odd = 0;
+        MyStl::for_each(d11.begin(), d11.end(), [&odd](int x) { odd += x & 1; });
+        FUN_VALUE(odd);
+        FUN_VALUE(reinterpret_cast<uintptr_t>(&d10[0]) % 4096);
+        FUN_VALUE(reinterpret_cast<uintptr_t>((d9.begin() + 7).first) % 64);
+        //移动语义和emplace，unique_ptr只能移动不能复制
+        MyStl::deque<std::unique_ptr<int>, 4> d13;
+        for (int i = 0; i < 6; ++i)
+            d13.emplace_back(new int(i));
+        d13.push_front(std::unique_ptr<int>(new int(-1)));
+        d13.emplace_front(new int(-2));
+        d13.emplace(d13.begin() + 2, new int(10));
+        d13.emplace(d13.end() - 2, new int(20));
+        d13.erase(d13.begin() + 4);
+        d13.erase(d13.end() - 2);
+        MyStl::deque<std::unique_ptr<int>, 4> d14(MyStl::move(d13));
+        std::cout << " d14 :";
+        for (const auto& p : d14)
+            std::cout << " " << *p;
+        std::cout << "\n";
+        FUN_VALUE(d13.size());
+        d13 = MyStl::move(d14);
+        FUN_VALUE(d13.size());
+        FUN_VALUE(d14.size());
+        d14.emplace_back(new int(42));
+        FUN_VALUE(*d14.front());
+        MyStl::deque<std::string> d15;
+        std::string str(64, 'x');
+        d15.push_back(MyStl::move(str));
+        d15.emplace_back(3, 'y');
+        d15.insert(d15.begin() + 1, std::string("z"));
+        PRINT(d15);
+        //shrink_to_fit和map的自动压缩
+        MyStl::deque<int, 4> d16;
+        for (int i = 0; i < 4000; ++i)
+            d16.push_back(i);
+        for (int i = 0; i < 3994; ++i)
+            d16.pop_front();
+        FUN_VALUE(d16.map_capacity());
+        FUN_AFTER(d16, d16.shrink_to_fit());
+        FUN_VALUE(d16.map_capacity());
+        for (int i = 0; i < 4000; ++i)
+            d16.push_back(i);
+        for (int i = 0; i < 4000; ++i)
+            d16.pop_front();
+        //高峰过去之后的稳定队列，重新居中时换成小map
+        for (int i = 0; i < 4000; ++i) {
+            d16.push_back(i);
+            d16.pop_front();
+        }
+        FUN_VALUE(d16.map_capacity());
+        FUN_VALUE(d16.size());
 
         std::cout << "[----------------------- end API test "
                      "---------------------------]\n";
@@ -0,0 +1,83 @@
+#ifndef MYSTL_TEST_DYNAMIC_BITSET_H
+#define MYSTL_TEST_DYNAMIC_BITSET_H
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include "test_Macros.h"
+#include "../dynamic_bitset.h"
+namespace MyStl{
+    void test_dynamic_bitset() {
+        std::cout << "[============================================================"
+                     "===]\n";
+        std::cout << "[--------------- Run container test : dynamic_bitset "
+                     "-----------------]\n";
+        std::cout << "[-------------------------- API test "
+                     "---------------------------]\n";
+        MyStl::dynamic_bitset b1(200);
+        MyStl::dynamic_bitset b2(200, true);
+        MyStl::dynamic_bitset b3;
+        for (int i = 0; i < 130; ++i)
+            b3.push_back(i % 3 == 0);
+        for (size_t i = 0; i < 200; i += 7)
+            b1[i] = true;
+        FUN_VALUE(b1.size());
+        FUN_VALUE(b1.num_words());
+        FUN_VALUE(b1.count());
+        FUN_VALUE(b2.count());
+        FUN_VALUE(b2.all());
+        FUN_VALUE(b3.count());
+        FUN_VALUE(b3[129]);
+        FUN_VALUE(b1.find_first());
+        FUN_VALUE(b1.find_next(0));
+        FUN_VALUE(b1.find_next(196));
+        //std::min按const&接收参数，会odr-use npos
+        FUN_VALUE((std::min(b1.find_next(b1.size() - 1), MyStl::dynamic_bitset::npos) == MyStl::dynamic_bitset::npos));
+        std::cout << " set bits of b3 below 20 :";
+        for (size_t i = b3.find_first(); i < 20; i = b3.find_next(i))
+            std::cout << " " << i;
+        std::cout << "\n";
+        MyStl::dynamic_bitset b4(b1);
+        b4 &= b2;
+        FUN_VALUE((b4 == b1));
+        b4 |= ~b1;
+        FUN_VALUE(b4.count());
+        b4.and_not(b1);
+        FUN_VALUE(b4.count());
+        b4 ^= b2;
+        FUN_VALUE((b4 == b1));
+        FUN_VALUE((b1 ^ b1).none());
+        b2.flip(3).reset(4);
+        FUN_VALUE(b2.count());
+        b2[5].flip();
+        FUN_VALUE(b2.test(5));
+        b3.resize(300, true);
+        FUN_VALUE(b3.count());
+        b3.resize(64);
+        FUN_VALUE(b3.count());
+        b3.pop_back();
+        FUN_VALUE(b3.size());
+        b3.clear();
+        FUN_VALUE(b3.empty());
+        std::cout << "[----------------------- end API test "
+                     "---------------------------]\n";
+        std::cout << "[------------------------ kernel test "
+                     "--------------------------]\n";
+        //运行时选择的实现必须与通用实现的结果一致
+        MyStl::dynamic_bitset x(1000), y(1000);
+        for (size_t i = 0; i < 1000; ++i) {
+            x[i] = (i * 2654435761u) % 5 < 2;
+            y[i] = (i * 40503u) % 3 == 0;
+        }
+        uint64_t expect[16];
+        const bit_kernels& k = bit_kernels::get();
+        std::memcpy(expect, x.data(), sizeof(expect));
+        bits_andnot_generic(expect, y.data(), x.num_words());
+        MyStl::dynamic_bitset z(x);
+        k.andnot_op(z.data(), y.data(), z.num_words());
+        FUN_VALUE((std::memcmp(expect, z.data(), z.num_words() * sizeof(uint64_t)) == 0));
+        FUN_VALUE((k.count(x.data(), x.num_words()) == bits_count_generic(x.data(), x.num_words())));
+        std::cout << "[--------------------- end kernel test "
+                     "--------------------------]\n";
+    }
+}
+#endif //MYSTL_TEST_DYNAMIC_BITSET_H
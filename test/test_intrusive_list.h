@@ -0,0 +1,98 @@
+
+#ifndef MYSTL_TEST_INTRUSIVE_LIST_H
+#define MYSTL_TEST_INTRUSIVE_LIST_H
+#include <iostream>
+#include <ctime>
+#include "test_Macros.h"
+#include "../intrusive_list.h"
+#include "../list.h"
+#include "../vector.h"
+namespace MyStl{
+    //同一个对象可以通过不同的hook同时挂在两个链表上
+    struct session{
+        int id;
+        char payload[48];
+        list_hook lru_hook;
+        list_hook timer_hook;
+        explicit session(int i = 0) : id(i), payload() {}
+    };
+    inline std::ostream& operator<<(std::ostream& os, const session& s) { return os << s.id; }
+
+    void test_intrusive_list() {
+        std::cout << "[============================================================"
+                     "===]\n";
+        std::cout << "[----------------- Run container test : intrusive_list "
+                     "-------------------]\n";
+        std::cout << "[-------------------------- API test "
+                     "---------------------------]\n";
+        session s[8];
+        for (int i = 0; i < 8; ++i)
+            s[i].id = i;
+        MyStl::intrusive_list<session, &session::lru_hook> lru;
+        MyStl::intrusive_list<session, &session::timer_hook> timers;
+        for (int i = 0; i < 5; ++i) {
+            lru.push_front(s[i]);
+            timers.push_back(s[i]);
+        }
+        PRINT(lru);
+        PRINT(timers);
+        //访问一个对象后把它移到LRU表头
+        FUN_AFTER(lru, lru.splice(lru.begin(), lru, lru.iterator_to(s[1])));
+        FUN_AFTER(lru, lru.pop_back());
+        FUN_VALUE(s[0].lru_hook.is_linked());
+        //已知对象时O(1)摘下
+        FUN_AFTER(timers, timers.erase(s[3]));
+        FUN_VALUE(timers.size());
+        FUN_AFTER(timers, timers.insert(timers.iterator_to(s[2]), s[7]));
+        FUN_VALUE(timers.front());
+        FUN_VALUE(timers.back());
+        MyStl::intrusive_list<session, &session::timer_hook> expired;
+        FUN_AFTER(expired, expired.splice(expired.end(), timers, timers.begin(), timers.iterator_to(s[2])));
+        FUN_VALUE(timers.size());
+        FUN_AFTER(expired, expired.swap(timers));
+        PRINT(timers);
+        MyStl::intrusive_list<session, &session::timer_hook> moved(MyStl::move(timers));
+        PRINT(moved);
+        FUN_VALUE(timers.empty());
+        FUN_AFTER(moved, moved.erase(moved.begin(), moved.end()));
+        FUN_VALUE(s[4].timer_hook.is_linked());
+        FUN_VALUE(lru.size());
+        std::cout << "[----------------------- end API test "
+                     "---------------------------]\n";
+
+        std::cout << "[--------------------- performance test "
+                     "------------------------]\n";
+        //已有的对象反复入队出队：list每次都要分配节点并拷贝对象，intrusive_list只修改指针
+        const int n = 1000, rounds = 2000;
+        MyStl::vector<session> objs(n);
+        MyStl::list<session> l;
+        MyStl::intrusive_list<session, &session::lru_hook> il;
+        long long sum1 = 0, sum2 = 0;
+        clock_t start = clock();
+        for (int r = 0; r < rounds; ++r) {
+            for (int i = 0; i < n; ++i)
+                l.push_back(objs[i]);
+            while (!l.empty()) {
+                sum1 += l.front().id;
+                l.pop_front();
+            }
+        }
+        clock_t end = clock();
+        std::cout << " list push/pop " << n * rounds << " objects : " << (end - start) * 1000 / CLOCKS_PER_SEC << " ms\n";
+        start = clock();
+        for (int r = 0; r < rounds; ++r) {
+            for (int i = 0; i < n; ++i)
+                il.push_back(objs[i]);
+            while (!il.empty()) {
+                sum2 += il.front().id;
+                il.pop_front();
+            }
+        }
+        end = clock();
+        std::cout << " intrusive_list push/pop " << n * rounds << " objects : " << (end - start) * 1000 / CLOCKS_PER_SEC << " ms\n";
+        FUN_VALUE((sum1 == sum2));
+        std::cout << "[------------------ end performance test "
+                     "-----------------------]\n";
+    }
+}
+#endif //MYSTL_TEST_INTRUSIVE_LIST_H
@@ -2,9 +2,62 @@
 #ifndef MYSTL_TEST_LIST_H
 #define MYSTL_TEST_LIST_H
 #include <iostream>
+#include <ctime>
+#include <random>
+#include <string>
+#include <stdexcept>
 #include "test_Macros.h"
 #include "../list.h"
 namespace MyStl{
+    //只按key比较，用来检查排序是否稳定
+    struct sort_item{
+        int key;
+        int order;
+        bool operator<(const sort_item& rhs) const { return key < rhs.key; }
+    };
+
+    //暴露不需要额外内存的归并排序，用作性能对比
+    template <typename T>
+    struct merge_sort_list : MyStl::list<T>{
+        void merge_sort() { MyStl::list<T>::merge_sort(typename MyStl::list<T>::value_less()); }
+    };
+
+    //没有默认构造函数，记录拷贝和移动的次数
+    struct heavy_item{
+        static int copies;
+        static int moves;
+        std::string name;
+        int weight;
+        heavy_item(const std::string& n, int w) : name(n), weight(w) {}
+        heavy_item(const heavy_item& rhs) : name(rhs.name), weight(rhs.weight) { ++copies; }
+        heavy_item(heavy_item&& rhs) : name(MyStl::move(rhs.name)), weight(rhs.weight) { ++moves; }
+    };
+    int heavy_item::copies = 0;
+    int heavy_item::moves = 0;
+    inline std::ostream& operator<<(std::ostream& os, const heavy_item& h) { return os << h.name << "/" << h.weight; }
+
+    //拷贝若干次之后抛出异常，用来检查批量插入失败时链表不变
+    struct throw_item{
+        static int budget;
+        int value;
+        explicit throw_item(int v) : value(v) {}
+        throw_item(const throw_item& rhs) : value(rhs.value) {
+            if (budget-- == 0)
+                throw std::runtime_error("copy failed");
+        }
+    };
+    int throw_item::budget = -1;
+    inline std::ostream& operator<<(std::ostream& os, const throw_item& t) { return os << t.value; }
+
+    template <typename List>
+    bool list_sorted(const List& l) {
+        auto prev = l.begin();
+        for (auto it = l.begin(); it != l.end(); prev = it++)
+            if (*it < *prev)
+                return false;
+        return true;
+    }
+
     void test_list() {
         std::cout << "[============================================================"
                      "===]\n";
@@ -58,8 +111,109 @@ namespace MyStl{
         FUN_AFTER(l1, l1.resize(30, 5));
         FUN_AFTER(l1, l1.clear());
         FUN_VALUE(l1.size());
+        //各种修改之后size都不需要遍历链表
+        MyStl::list<int> l8 = {1, 3, 5, 7};
+        MyStl::list<int> l9 = {2, 4, 6, 8, 10};
+        FUN_AFTER(l8, l8.merge(l9));
+        FUN_VALUE(l8.size());
+        FUN_VALUE(l9.size());
+        FUN_AFTER(l9, l9.splice(l9.end(), l8, l8.begin() + 2, l8.begin() + 5));
+        FUN_VALUE(l8.size());
+        FUN_VALUE(l9.size());
+        FUN_AFTER(l8, l8.splice(l8.begin(), l8, l8.end() - 1));
+        FUN_AFTER(l8, l8.remove(*l8.begin()));
+        FUN_VALUE(l8.size());
+        l9 = {9, 9, 9};
+        PRINT(l9);
+        FUN_VALUE(l9.size());
+        //非算术类型排序节点指针，相等的元素保持原来的顺序
+        MyStl::list<sort_item> l10;
+        for (int i = 0; i < 1000; ++i)
+            l10.push_back(sort_item{(i * 7919) % 10, i});
+        l10.sort();
+        bool stable = true;
+        for (auto it = l10.begin(), prev = it++; it != l10.end(); prev = it++)
+            if (prev->key == it->key && prev->order > it->order)
+                stable = false;
+        FUN_VALUE((list_sorted(l10) && stable));
+        FUN_VALUE(l10.size());
+        //自定义比较器和谓词，不需要包装元素
+        MyStl::list<int> l13 = {5, -3, 2, -8, 1, 3, -2};
+        FUN_AFTER(l13, l13.sort([](int x, int y) { return (x < 0 ? -x : x) < (y < 0 ? -y : y); }));
+        MyStl::list<int> l14 = {9, 6, 4, 1};
+        MyStl::list<int> l15 = {8, 7, 4, 0};
+        FUN_AFTER(l14, l14.merge(l15, [](int x, int y) { return x > y; }));
+        FUN_VALUE(l14.size());
+        FUN_AFTER(l13, l13.unique([](int x, int y) { return x == -y; }));
+        FUN_AFTER(l14, l14.unique([](int x, int y) { return x - y < 2; }));
+        FUN_AFTER(l14, l14.remove_if([](int x) { return x % 2 == 0; }));
+        FUN_VALUE(l14.size());
+        //emplace在节点中直接构造，右值push只移动；PRINT按值遍历会拷贝元素，所以先记下次数再打印
+        MyStl::list<heavy_item> l16;
+        l16.emplace_back("b", 2);
+        l16.emplace_front("a", 1);
+        l16.emplace(++l16.begin(), "c", 3);
+        heavy_item h("d", 4);
+        l16.push_back(MyStl::move(h));
+        l16.insert(l16.begin(), heavy_item("e", 5));
+        int copies = heavy_item::copies, moves = heavy_item::moves;
+        FUN_VALUE(copies);
+        FUN_VALUE(moves);
+        PRINT(l16);
+        //移动构造和移动赋值只交换哨兵节点，不拷贝也不移动元素
+        heavy_item::copies = heavy_item::moves = 0;
+        MyStl::list<heavy_item> l17(MyStl::move(l16));
+        l16.push_back(heavy_item("f", 6));
+        l17 = MyStl::move(l16);
+        copies = heavy_item::copies;
+        moves = heavy_item::moves;
+        FUN_VALUE(copies);
+        FUN_VALUE(moves);
+        FUN_VALUE(l16.size());
+        PRINT(l17);
+        //批量插入返回第一个新元素，区间可以来自链表自身
+        MyStl::list<int> l19{1, 2, 3};
+        FUN_VALUE(*l19.insert(++l19.begin(), 2, 7));
+        FUN_VALUE((l19.insert(l19.begin(), 0, 7) == l19.begin()));
+        FUN_AFTER(l19, l19.insert(l19.end(), l19.begin(), l19.end()));
+        FUN_VALUE(l19.size());
+        //第三次拷贝失败，已经构造的两个节点被释放，原链表不变
+        MyStl::list<throw_item> l20;
+        l20.push_back(throw_item(1));
+        l20.push_back(throw_item(2));
+        throw_item::budget = 2;
+        try {
+            l20.insert(++l20.begin(), 5, throw_item(9));
+        } catch (const std::runtime_error& e) {
+            std::cout << " insert threw: " << e.what() << "\n";
+        }
+        throw_item::budget = -1;
+        PRINT(l20);
+        FUN_VALUE(l20.size());
         std::cout << "[----------------------- end API test "
                      "---------------------------]\n";
+
+        std::cout << "[--------------------- performance test "
+                     "------------------------]\n";
+        const int n = 2000000;
+        std::mt19937 rng(42);
+        merge_sort_list<int> l11, l12;
+        for (int i = 0; i < n; ++i) {
+            const int v = int(rng() % n);
+            l11.push_back(v);
+            l12.push_back(v);
+        }
+        clock_t start = clock();
+        l11.sort();
+        clock_t end = clock();
+        std::cout << " sort " << n << " random ints : " << (end - start) * 1000 / CLOCKS_PER_SEC << " ms\n";
+        start = clock();
+        l12.merge_sort();
+        end = clock();
+        std::cout << " merge sort " << n << " random ints : " << (end - start) * 1000 / CLOCKS_PER_SEC << " ms\n";
+        FUN_VALUE((list_sorted(l11) && l11.size() == l12.size()));
+        std::cout << "[------------------ end performance test "
+                     "-----------------------]\n";
     }
 }
 
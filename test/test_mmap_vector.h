@@ -0,0 +1,68 @@
+#ifndef MYSTL_TEST_MMAP_VECTOR_H
+#define MYSTL_TEST_MMAP_VECTOR_H
+#include <iostream>
+#include <cstdio>
+#include <stdexcept>
+#include "test_Macros.h"
+#include "../mmap_vector.h"
+namespace MyStl{
+    void test_mmap_vector() {
+        std::cout << "[============================================================"
+                     "===]\n";
+        std::cout << "[----------------- Run container test : mmap_vector "
+                     "-------------------]\n";
+        std::cout << "[-------------------------- API test "
+                     "---------------------------]\n";
+        const char* path = "mystl_mmap_vector_test.bin";
+        std::remove(path);
+        {
+            MyStl::mmap_vector<int> v1(path);
+            for (int i = 1; i <= 5; ++i)
+                v1.push_back(i);
+            PRINT(v1);
+            FUN_VALUE(v1.size());
+            FUN_VALUE(v1.capacity());
+            FUN_AFTER(v1, v1.resize(8, 7));
+            FUN_AFTER(v1, v1.pop_back());
+            FUN_AFTER(v1, v1.reserve(1000));
+            FUN_VALUE(v1.capacity());
+            v1.flush();
+        }
+        {
+            //重新打开，内容应当保持不变
+            MyStl::mmap_vector<int> v2(path);
+            PRINT(v2);
+            FUN_VALUE(v2.front());
+            FUN_VALUE(v2.back());
+            FUN_VALUE(v2[3]);
+            FUN_VALUE(v2.capacity());
+            //参数引用本容器中的元素，扩容时映射区可能移动
+            while (v2.size() < v2.capacity())
+                v2.push_back(v2.back() + 1);
+            v2.push_back(v2[0]);
+            FUN_VALUE(v2.back());
+            v2.resize(v2.capacity() + 1, v2[0]);
+            FUN_VALUE(v2.back());
+            FUN_VALUE(v2.size());
+            FUN_AFTER(v2, v2.clear());
+            FUN_VALUE(v2.empty());
+        }
+        {
+            //文件头中的size(偏移16)大于capacity时拒绝打开
+            FILE* file = std::fopen(path, "r+b");
+            unsigned long long bad_size = 1ULL << 40;
+            std::fseek(file, 16, SEEK_SET);
+            std::fwrite(&bad_size, sizeof(bad_size), 1, file);
+            std::fclose(file);
+            try {
+                MyStl::mmap_vector<int> v3(path);
+            } catch (const std::runtime_error& e) {
+                std::cout << " open threw: " << e.what() << "\n";
+            }
+        }
+        std::remove(path);
+        std::cout << "[----------------------- end API test "
+                     "---------------------------]\n";
+    }
+}
+#endif //MYSTL_TEST_MMAP_VECTOR_H
@@ -0,0 +1,168 @@
+
+#ifndef MYSTL_TEST_MPMC_QUEUE_H
+#define MYSTL_TEST_MPMC_QUEUE_H
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include "test_Macros.h"
+#include "../mpmc_queue.h"
+#include "../queue.h"
+namespace MyStl{
+    //用互斥锁保护的queue，作为性能对比的基准
+    struct locked_queue{
+        std::mutex mtx;
+        MyStl::queue<long> q;
+        void push_n(const long* first, MyStl::size_t n) {
+            std::lock_guard<std::mutex> lock(mtx);
+            for (MyStl::size_t i = 0; i < n; ++i)
+                q.push(first[i]);
+        }
+        MyStl::size_t pop_n(long* result, MyStl::size_t n) {
+            MyStl::size_t got = 0;
+            while (got == 0) {
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    for (; got < n && !q.empty(); ++got) {
+                        result[got] = q.front();
+                        q.pop();
+                    }
+                }
+                if (got == 0)
+                    std::this_thread::yield();
+            }
+            return got;
+        }
+    };
+
+    //producers个线程各写入per_thread个数，consumers个线程读完全部元素
+    //每个线程以batch个元素为一批提交，返回耗时(毫秒)，sum为读到的元素之和
+    template <typename Queue>
+    long long run_queue_bench(Queue& q, int producers, int consumers, long per_thread,
+                              MyStl::size_t batch, long& sum) {
+        const long total = per_thread * producers;
+        std::atomic<long> remaining(total);
+        std::atomic<long> total_sum(0);
+        std::thread threads[16];
+        auto start = std::chrono::steady_clock::now();
+        for (int p = 0; p < producers; ++p)
+            threads[p] = std::thread([&q, p, per_thread, batch]() {
+                long buf[64];
+                for (long next = 0; next < per_thread; ) {
+                    MyStl::size_t cnt = 0;
+                    for (; cnt < batch && next < per_thread; ++cnt, ++next)
+                        buf[cnt] = p * per_thread + next;
+                    q.push_n(buf, cnt);
+                }
+            });
+        for (int c = 0; c < consumers; ++c)
+            threads[producers + c] = std::thread([&q, &remaining, &total_sum, batch]() {
+                long buf[64];
+                long local = 0;
+                //先领取要读的个数，保证每个消费者都能读完自己领到的元素后退出
+                for (;;) {
+                    long want = remaining.fetch_sub(long(batch));
+                    if (want <= 0)
+                        break;
+                    if (want > long(batch))
+                        want = long(batch);
+                    while (want > 0) {
+                        MyStl::size_t got = q.pop_n(buf, MyStl::size_t(want));
+                        for (MyStl::size_t i = 0; i < got; ++i)
+                            local += buf[i];
+                        want -= long(got);
+                    }
+                }
+                total_sum += local;
+            });
+        for (int i = 0; i < producers + consumers; ++i)
+            threads[i].join();
+        auto end = std::chrono::steady_clock::now();
+        sum = total_sum.load();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    }
+
+    void test_mpmc_queue() {
+        std::cout << "[============================================================"
+                     "===]\n";
+        std::cout << "[----------------- Run container test : mpmc_queue "
+                     "-------------------]\n";
+        std::cout << "[-------------------------- API test "
+                     "---------------------------]\n";
+        MyStl::mpmc_queue<std::string> q1(5);
+        FUN_VALUE(q1.capacity());
+        FUN_VALUE(q1.empty());
+        q1.push("a");
+        q1.push("b");
+        FUN_VALUE(q1.size());
+        std::string words[] = {"c", "d", "e", "f", "g", "h", "i", "j"};
+        //std::string的拷贝可能抛出异常，只能移动进队列
+        FUN_VALUE(q1.try_push_n(std::make_move_iterator(words), 8));
+        FUN_VALUE(q1.try_push("k"));
+        std::string out[8];
+        FUN_VALUE(q1.try_pop_n(out, 3));
+        std::cout << " popped : " << out[0] << " " << out[1] << " " << out[2] << "\n";
+        q1.push_n(std::make_move_iterator(words + 6), 2);
+        std::string s;
+        while (q1.try_pop(s))
+            std::cout << " " << s;
+        std::cout << "\n";
+        FUN_VALUE(q1.empty());
+        std::cout << "[----------------------- end API test "
+                     "---------------------------]\n";
+
+        std::cout << "[------------------------ thread test "
+                     "--------------------------]\n";
+        //多个线程逐个push/pop，队列很小，会经常走到futex睡眠的路径
+        {
+            MyStl::mpmc_queue<long> q2(16);
+            const long per_thread = 20000;
+            std::atomic<long> sum(0);
+            std::thread threads[8];
+            for (int p = 0; p < 4; ++p)
+                threads[p] = std::thread([&q2, p, per_thread]() {
+                    for (long i = 0; i < per_thread; ++i)
+                        q2.push(p * per_thread + i);
+                });
+            for (int c = 0; c < 4; ++c)
+                threads[4 + c] = std::thread([&q2, &sum, per_thread]() {
+                    long local = 0, v;
+                    for (long i = 0; i < per_thread; ++i) {
+                        q2.pop(v);
+                        local += v;
+                    }
+                    sum += local;
+                });
+            for (int i = 0; i < 8; ++i)
+                threads[i].join();
+            const long n = 4 * per_thread;
+            FUN_VALUE((sum.load() == n * (n - 1) / 2));
+            FUN_VALUE(q2.empty());
+        }
+        std::cout << "[--------------------- end thread test "
+                     "--------------------------]\n";
+
+        std::cout << "[--------------------- performance test "
+                     "------------------------]\n";
+        const long per_thread = 200000;
+        const int configs[][2] = {{1, 1}, {2, 2}, {4, 4}};
+        for (const auto& cfg : configs) {
+            const long n = per_thread * cfg[0];
+            long sum1 = 0, sum2 = 0;
+            MyStl::mpmc_queue<long> mq(1024);
+            locked_queue lq;
+            long long t1 = run_queue_bench(mq, cfg[0], cfg[1], per_thread, 32, sum1);
+            long long t2 = run_queue_bench(lq, cfg[0], cfg[1], per_thread, 32, sum2);
+            std::cout << " " << cfg[0] << " producers / " << cfg[1] << " consumers, "
+                      << n << " numbers, batch 32 : mpmc_queue " << t1
+                      << " ms, mutex + queue " << t2 << " ms, sums match : "
+                      << (sum1 == n * (n - 1) / 2 && sum2 == sum1) << "\n";
+        }
+        std::cout << "[------------------ end performance test "
+                     "-----------------------]\n";
+    }
+}
+#endif //MYSTL_TEST_MPMC_QUEUE_H
@@ -0,0 +1,72 @@
+#ifndef MYSTL_TEST_PERSISTENT_VECTOR_H
+#define MYSTL_TEST_PERSISTENT_VECTOR_H
+#include <iostream>
+#include <thread>
+#include <stdexcept>
+#include "test_Macros.h"
+#include "../persistent_vector.h"
+namespace MyStl{
+    void test_persistent_vector() {
+        std::cout << "[============================================================"
+                     "===]\n";
+        std::cout << "[----------------- Run container test : persistent_vector "
+                     "-------------------]\n";
+        std::cout << "[-------------------------- API test "
+                     "---------------------------]\n";
+        int a[] = {1, 2, 3, 4, 5};
+        MyStl::persistent_vector<int> p1;
+        MyStl::persistent_vector<int> p2(a, a + 5);
+        MyStl::persistent_vector<int> p3 = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+        MyStl::persistent_vector<int> p4(p3);
+        p1 = p2.push_back(6);
+        PRINT(p1);
+        PRINT(p2);
+        PRINT(p3);
+        PRINT(p4);
+        //修改返回新的快照，原对象不变
+        MyStl::persistent_vector<int> p5 = p3.set(0, 100).pop_back();
+        PRINT(p3);
+        PRINT(p5);
+        //批量修改
+        MyStl::transient_vector<int> t1 = p5.transient();
+        for (int i = 0; i < 2000; ++i)
+            t1.push_back(i);
+        t1.set(1500, -1);
+        t1.pop_back();
+        MyStl::persistent_vector<int> p6 = t1.persistent();
+        FUN_VALUE(t1.size());
+        FUN_VALUE(p5.size());
+        FUN_VALUE(p6.size());
+        FUN_VALUE(p6.front());
+        FUN_VALUE(p6.back());
+        FUN_VALUE(p6[1500]);
+        FUN_VALUE(p6[1501]);
+        FUN_VALUE(*(p6.end() - 1));
+        FUN_VALUE(p6.end() - p6.begin());
+        FUN_VALUE(p6.empty());
+        try {
+            p6.at(p6.size());
+        } catch (const std::out_of_range& e) {
+            std::cout << " at threw: " << e.what() << "\n";
+        }
+        //读线程持有快照的最后一个引用并析构，同时写线程继续修改
+        long sum = 0;
+        {
+            MyStl::persistent_vector<int> snap = p6;
+            p6 = MyStl::persistent_vector<int>();
+            std::thread reader([&sum](MyStl::persistent_vector<int> v) {
+                for (int x : v)
+                    sum += x;
+            }, MyStl::move(snap));
+            MyStl::transient_vector<int> t2 = p5.transient();
+            for (int i = 0; i < 2000; ++i)
+                t2.push_back(i);
+            reader.join();
+            FUN_VALUE(t2.size());
+        }
+        FUN_VALUE(sum);
+        std::cout << "[----------------------- end API test "
+                     "---------------------------]\n";
+    }
+}
+#endif //MYSTL_TEST_PERSISTENT_VECTOR_H
@@ -5,6 +5,7 @@
 #include "test_Macros.h"
 #include "deque.h"
 #include "iostream"
+#include <string>
 namespace MyStl{
     void test_priority_queue() {
         std::cout << "[============================================================"
@@ -31,6 +32,23 @@ namespace MyStl{
         FUN_VALUE(q1.top());
         std::cout << std::endl;
 
+        //乱序的初始序列建堆，再依次弹出
+        int b[] = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+        MyStl::priority_queue<int> q2(b, b + 10);
+        std::cout << " q2 pop order :";
+        while (!q2.empty()) {
+            std::cout << " " << q2.top();
+            q2.pop();
+        }
+        std::cout << "\n";
+        MyStl::priority_queue<std::string> q3;
+        q3.emplace(3, 'b');
+        q3.push(std::string("c"));
+        q3.emplace("a");
+        FUN_VALUE(q3.top());
+        q3.pop();
+        FUN_VALUE(q3.top());
+
         std::cout << "[----------------------- end API test "
                      "---------------------------]\n";
     }
@@ -49,6 +49,26 @@ namespace MyStl{
         std::cout << "After q2.pop() -> ";
         FUN_VALUE(q2.front());
 
+        std::cout << std::endl;
+        std::cout << "[----------------- Underlying container : deque<int, 1024> "
+                     "-------------------]\n";
+        MyStl::block_queue<int, 1024> q3;
+        for (int i = 0; i < 5000; ++i)
+            q3.push(i);
+        for (int i = 0; i < 4000; ++i)
+            q3.pop();
+        FUN_VALUE(q3.size());
+        FUN_VALUE(q3.front());
+        FUN_VALUE(q3.back());
+        //深度稳定的队列，缓冲区在pop和push之间循环使用
+        for (int i = 5000; i < 105000; ++i) {
+            q3.push(i);
+            q3.pop();
+        }
+        FUN_VALUE(q3.size());
+        FUN_VALUE(q3.front());
+        FUN_VALUE(q3.back());
+
 
         std::cout << "[----------------------- end API test "
                      "---------------------------]\n";
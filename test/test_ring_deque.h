@@ -0,0 +1,89 @@
+#ifndef MYSTL_TEST_RING_DEQUE_H
+#define MYSTL_TEST_RING_DEQUE_H
+#include <iostream>
+#include <string>
+#include "test_Macros.h"
+#include "../ring_deque.h"
+#include "../queue.h"
+namespace MyStl{
+    void test_ring_deque() {
+        std::cout << "[============================================================"
+                     "===]\n";
+        std::cout << "[----------------- Run container test : ring_deque "
+                     "-------------------]\n";
+        std::cout << "[-------------------------- API test "
+                     "---------------------------]\n";
+        MyStl::ring_deque<int> r1;
+        MyStl::ring_deque<int, 4> r2 = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+        MyStl::ring_deque<int, 4> r3(r2);
+        MyStl::ring_deque<int, 4> r4(3, 7);
+        PRINT(r2);
+        PRINT(r3);
+        PRINT(r4);
+        FUN_AFTER(r2, r2.push_front(0));
+        FUN_AFTER(r2, r2.push_back(10));
+        FUN_AFTER(r2, r2.pop_front());
+        FUN_AFTER(r2, r2.pop_back());
+        FUN_VALUE(r2.front());
+        FUN_VALUE(r2.back());
+        FUN_VALUE(r2[4]);
+        FUN_VALUE(r2.end() - r2.begin());
+        FUN_VALUE((r2 == r3));
+        r4 = r2;
+        FUN_VALUE((r4 == r3));
+        FUN_AFTER(r4, r4.clear());
+        FUN_VALUE(r4.empty());
+        //只在尾部push、头部pop，map的容量保持不变
+        for (int i = 0; i < 1000; ++i)
+            r1.push_back(i);
+        //先循环一个缓冲区以上的长度，让map达到稳定的大小
+        for (int i = 1000; i < 2000; ++i) {
+            r1.push_back(i);
+            r1.pop_front();
+        }
+        MyStl::size_t cap = r1.map_capacity();
+        for (int i = 2000; i < 200000; ++i) {
+            r1.push_back(i);
+            r1.pop_front();
+        }
+        FUN_VALUE(r1.size());
+        FUN_VALUE(r1.front());
+        FUN_VALUE(r1.back());
+        FUN_VALUE((r1.map_capacity() == cap));
+        //突发的高峰过去之后map缩回较小的容量
+        for (int i = 0; i < 200000; ++i)
+            r1.push_back(i);
+        MyStl::size_t peak = r1.map_capacity();
+        while (r1.size() > 10)
+            r1.pop_front();
+        FUN_VALUE(peak);
+        FUN_VALUE(r1.map_capacity());
+        FUN_VALUE(r1.front());
+        MyStl::ring_queue<int> q;
+        for (int i = 0; i < 10; ++i)
+            q.push(i);
+        q.pop();
+        FUN_VALUE(q.front());
+        FUN_VALUE(q.size());
+        //右值push只移动，emplace在缓冲区中直接构造
+        MyStl::ring_deque<std::string, 4> r5;
+        std::string big(100, 'b');
+        std::string small("f");
+        r5.push_back(MyStl::move(big));
+        r5.push_front(MyStl::move(small));
+        r5.emplace_back(3, 'e');
+        r5.emplace_front("g");
+        PRINT(r5);
+        FUN_VALUE((big.empty() && small.empty()));
+        MyStl::ring_queue<std::string> q2;
+        std::string msg("moved");
+        q2.push(MyStl::move(msg));
+        q2.emplace(2, 'x');
+        FUN_VALUE(msg.empty());
+        FUN_VALUE(q2.front());
+        FUN_VALUE(q2.back());
+        std::cout << "[----------------------- end API test "
+                     "---------------------------]\n";
+    }
+}
+#endif //MYSTL_TEST_RING_DEQUE_H
@@ -0,0 +1,145 @@
+
+#ifndef MYSTL_TEST_SKIP_LIST_H
+#define MYSTL_TEST_SKIP_LIST_H
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <ctime>
+#include <random>
+#include "test_Macros.h"
+#include "../skip_list.h"
+#include "../vector.h"
+namespace MyStl{
+    template <typename K, typename V>
+    std::ostream& operator<<(std::ostream& os, const std::pair<const K, V>& p) {
+        return os << p.first << "=" << p.second;
+    }
+
+    //第budget次拷贝时抛出异常
+    struct skip_throw_item{
+        static int budget;
+        int value;
+        explicit skip_throw_item(int v) : value(v) {}
+        skip_throw_item(const skip_throw_item& rhs) : value(rhs.value) {
+            if (budget-- == 0)
+                throw std::runtime_error("copy failed");
+        }
+    };
+    int skip_throw_item::budget = -1;
+
+    void test_skip_list() {
+        std::cout << "[============================================================"
+                     "===]\n";
+        std::cout << "[----------------- Run container test : skip_list "
+                     "-------------------]\n";
+        std::cout << "[-------------------------- API test "
+                     "---------------------------]\n";
+        MyStl::skip_list<std::string, int> s1 = {{"pear", 3}, {"apple", 1}, {"fig", 2}};
+        PRINT(s1);
+        FUN_AFTER(s1, s1.insert("kiwi", 4));
+        FUN_VALUE(s1.insert("fig", 9).second);
+        FUN_AFTER(s1, s1.emplace("banana", 5));
+        FUN_VALUE(s1.find("kiwi")->second);
+        FUN_VALUE((s1.find("grape") == s1.end()));
+        FUN_VALUE(s1.lower_bound("c")->first);
+        FUN_VALUE((s1.lower_bound("q") == s1.end()));
+        FUN_VALUE(s1.contains("apple"));
+        FUN_AFTER(s1, s1.erase("apple"));
+        FUN_VALUE(s1.erase("apple"));
+        FUN_AFTER(s1, s1.erase(s1.find("fig")));
+        FUN_VALUE(s1.size());
+        MyStl::skip_list<std::string, int> s2(s1);
+        PRINT(s2);
+        //降序比较器
+        MyStl::skip_list<int, int, std::greater<int>> s3;
+        for (int i = 0; i < 10; ++i)
+            s3.insert(i, i * i);
+        PRINT(s3);
+        FUN_VALUE(s3.lower_bound(4)->second);
+        FUN_AFTER(s3, s3.clear());
+        FUN_VALUE(s3.empty());
+        //拷贝构造中途失败时，已插入的节点由析构函数释放一次
+        MyStl::skip_list<int, skip_throw_item> s4;
+        for (int i = 0; i < 10; ++i)
+            s4.insert(i, skip_throw_item(i));
+        skip_throw_item::budget = 5;
+        try {
+            MyStl::skip_list<int, skip_throw_item> s5(s4);
+        } catch (const std::runtime_error& e) {
+            std::cout << " copy threw: " << e.what() << "\n";
+        }
+        skip_throw_item::budget = -1;
+        FUN_VALUE(s4.size());
+        std::cout << "[----------------------- end API test "
+                     "---------------------------]\n";
+
+        std::cout << "[------------------------ thread test "
+                     "--------------------------]\n";
+        //一个写线程插入、删除，三个读线程不加锁地查找和遍历
+        {
+            MyStl::skip_list<int, int, std::less<int>, true> s4;
+            const int n = 20000;
+            std::atomic<bool> done(false);
+            std::atomic<int> bad(0);
+            std::thread readers[3];
+            for (int r = 0; r < 3; ++r)
+                readers[r] = std::thread([&s4, &done, &bad]() {
+                    while (!done.load(std::memory_order_acquire)) {
+                        //读到的元素必须有序，值必须是完整写入的
+                        int prev = -1;
+                        for (auto it = s4.begin(); it != s4.end(); ++it) {
+                            if (it->first <= prev || it->second != it->first * 2)
+                                ++bad;
+                            prev = it->first;
+                        }
+                        auto it = s4.find(n / 2);
+                        if (it != s4.end() && it->second != n)
+                            ++bad;
+                    }
+                });
+            for (int i = 0; i < n; ++i) {
+                s4.insert(i, i * 2);
+                if (i % 3 == 0)
+                    s4.erase(i / 2);
+            }
+            done.store(true, std::memory_order_release);
+            for (int r = 0; r < 3; ++r)
+                readers[r].join();
+            s4.reclaim();
+            FUN_VALUE(bad.load());
+            FUN_VALUE(s4.size());
+        }
+        std::cout << "[--------------------- end thread test "
+                     "--------------------------]\n";
+
+        std::cout << "[--------------------- performance test "
+                     "------------------------]\n";
+        const int n = 200000;
+        MyStl::vector<int> keys;
+        std::mt19937 rng(7);
+        for (int i = 0; i < n; ++i)
+            keys.push_back(int(rng()));
+        MyStl::skip_list<int, int> s5;
+        clock_t start = clock();
+        for (int i = 0; i < n; ++i)
+            s5.insert(keys[i], i);
+        clock_t end = clock();
+        std::cout << " skip_list insert " << n << " random ints : " << (end - start) * 1000 / CLOCKS_PER_SEC << " ms\n";
+        long long found = 0;
+        start = clock();
+        for (int i = 0; i < n; ++i)
+            found += s5.contains(keys[i]);
+        end = clock();
+        std::cout << " skip_list find " << n << " random ints : " << (end - start) * 1000 / CLOCKS_PER_SEC << " ms\n";
+        bool sorted = true;
+        for (auto it = s5.begin(), next = it; ++next != s5.end(); it = next)
+            if (!(it->first < next->first))
+                sorted = false;
+        FUN_VALUE((found == n && sorted && s5.size() <= MyStl::size_t(n)));
+        std::cout << "[------------------ end performance test "
+                     "-----------------------]\n";
+    }
+}
+#endif //MYSTL_TEST_SKIP_LIST_H
@@ -0,0 +1,49 @@
+#ifndef MYSTL_TEST_SOA_VECTOR_H
+#define MYSTL_TEST_SOA_VECTOR_H
+#include <iostream>
+#include <string>
+#include "test_Macros.h"
+#include "../soa_vector.h"
+namespace MyStl{
+    void test_soa_vector() {
+        std::cout << "[============================================================"
+                     "===]\n";
+        std::cout << "[----------------- Run container test : soa_vector "
+                     "-------------------]\n";
+        std::cout << "[-------------------------- API test "
+                     "---------------------------]\n";
+        MyStl::soa_vector<int, double, std::string> s1;
+        for (int i = 0; i < 12; ++i)
+            s1.push_back(i, i * 0.5, std::string(1, char('a' + i)));
+        MyStl::soa_vector<int, double, std::string> s2(s1);
+        MyStl::soa_vector<int, double, std::string> s3(3);
+        s3 = s1;
+        auto ids = s1.column<0>();
+        auto values = s1.column<1>();
+        auto names = s2.column<2>();
+        PRINT(ids);
+        PRINT(values);
+        PRINT(names);
+        FUN_VALUE(s1.size());
+        FUN_VALUE(s1.capacity());
+        FUN_VALUE(std::get<2>(s1[3]));
+        FUN_VALUE(std::get<1>(s3.back()));
+        std::get<0>(s1.front()) = 100;
+        FUN_VALUE(s1.data<0>()[0]);
+        int sum = 0;
+        for (auto row : s1)
+            sum += std::get<0>(row);
+        FUN_VALUE(sum);
+        FUN_VALUE(s1.end() - s1.begin());
+        s1.pop_back();
+        FUN_VALUE(s1.size());
+        s1.resize(15);
+        auto names2 = s1.column<2>();
+        PRINT(names2);
+        s1.clear();
+        FUN_VALUE(s1.empty());
+        std::cout << "[----------------------- end API test "
+                     "---------------------------]\n";
+    }
+}
+#endif //MYSTL_TEST_SOA_VECTOR_H
@@ -0,0 +1,81 @@
+#ifndef MYSTL_TEST_SPSC_QUEUE_H
+#define MYSTL_TEST_SPSC_QUEUE_H
+#include <iostream>
+#include <string>
+#include <thread>
+#include "test_Macros.h"
+#include "../spsc_queue.h"
+namespace MyStl{
+    void test_spsc_queue() {
+        std::cout << "[============================================================"
+                     "===]\n";
+        std::cout << "[----------------- Run container test : spsc_queue "
+                     "-------------------]\n";
+        std::cout << "[-------------------------- API test "
+                     "---------------------------]\n";
+        MyStl::spsc_queue<std::string> q1(5);
+        FUN_VALUE(q1.capacity());
+        FUN_VALUE(q1.empty());
+        q1.push("a");
+        q1.push("b");
+        FUN_VALUE(q1.front());
+        q1.pop();
+        FUN_VALUE(q1.size());
+        std::string words[] = {"c", "d", "e", "f", "g", "h", "i", "j"};
+        FUN_VALUE(q1.try_push_n(words, 8));
+        FUN_VALUE(q1.try_push("k"));
+        std::string out[8];
+        FUN_VALUE(q1.try_pop_n(out, 3));
+        std::cout << " popped : " << out[0] << " " << out[1] << " " << out[2] << "\n";
+        std::string s;
+        while (q1.try_pop(s))
+            std::cout << " " << s;
+        std::cout << "\n";
+        FUN_VALUE(q1.empty());
+        //右值入队和出队都是移动，长字符串不会被深拷贝
+        std::string big(1000, 'x');
+        const char* data = big.data();
+        q1.push(MyStl::move(big));
+        FUN_VALUE(big.empty());
+        FUN_VALUE(q1.try_pop(s));
+        FUN_VALUE((s.data() == data));
+        std::cout << "[----------------------- end API test "
+                     "---------------------------]\n";
+        std::cout << "[------------------------ thread test "
+                     "--------------------------]\n";
+        //一个生产者线程和一个消费者线程，检查顺序和总和
+        MyStl::spsc_queue<long> q2(1024);
+        const long n = 1000000;
+        std::thread producer([&q2, n]() {
+            long batch[64];
+            long next = 0;
+            while (next < n) {
+                long cnt = 0;
+                for (; cnt < 64 && next + cnt < n; ++cnt)
+                    batch[cnt] = next + cnt;
+                long done = 0;
+                while (done < cnt)
+                    done += long(q2.try_push_n(batch + done, MyStl::size_t(cnt - done)));
+                next += cnt;
+            }
+        });
+        long expect = 0, sum = 0;
+        bool ordered = true;
+        long buf[32];
+        while (expect < n) {
+            MyStl::size_t got = q2.try_pop_n(buf, 32);
+            for (MyStl::size_t i = 0; i < got; ++i) {
+                ordered = ordered && buf[i] == expect;
+                sum += buf[i];
+                ++expect;
+            }
+        }
+        producer.join();
+        FUN_VALUE(ordered);
+        FUN_VALUE(sum);
+        FUN_VALUE(q2.empty());
+        std::cout << "[--------------------- end thread test "
+                     "--------------------------]\n";
+    }
+}
+#endif //MYSTL_TEST_SPSC_QUEUE_H
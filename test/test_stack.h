@@ -47,6 +47,17 @@ namespace MyStl{
         std::cout << "After s2.pop() -> ";
         FUN_VALUE(s2.top());
 
+        std::cout << std::endl;
+        std::cout << "[----------------- Underlying container : deque<int, 16> "
+                     "-------------------]\n";
+        MyStl::block_stack<int, 16> s3;
+        for (int i = 0; i < 100; ++i)
+            s3.push(i);
+        for (int i = 0; i < 40; ++i)
+            s3.pop();
+        FUN_VALUE(s3.size());
+        FUN_VALUE(s3.top());
+
         std::cout << "[----------------------- end API test "
                      "---------------------------]\n";
 
@@ -0,0 +1,94 @@
+
+#ifndef MYSTL_TEST_UNROLLED_LIST_H
+#define MYSTL_TEST_UNROLLED_LIST_H
+#include <iostream>
+#include <ctime>
+#include "test_Macros.h"
+#include "../unrolled_list.h"
+#include "../list.h"
+namespace MyStl{
+    void test_unrolled_list() {
+        std::cout << "[============================================================"
+                     "===]\n";
+        std::cout << "[----------------- Run container test : unrolled_list "
+                     "-------------------]\n";
+        std::cout << "[-------------------------- API test "
+                     "---------------------------]\n";
+        MyStl::unrolled_list<int, 4> u1;
+        MyStl::unrolled_list<int, 4> u2 = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+        MyStl::unrolled_list<int, 4> u3(u2);
+        MyStl::unrolled_list<int, 4> u4(3, 7);
+        PRINT(u2);
+        PRINT(u3);
+        PRINT(u4);
+        FUN_VALUE(u2.node_count());
+        FUN_AFTER(u2, u2.push_front(0));
+        FUN_AFTER(u2, u2.push_back(10));
+        FUN_AFTER(u2, u2.pop_front());
+        FUN_AFTER(u2, u2.pop_back());
+        FUN_VALUE(u2.front());
+        FUN_VALUE(u2.back());
+        FUN_VALUE((u2 == u3));
+        //在满节点中间插入会分裂节点
+        auto it = u2.begin();
+        ++it; ++it;
+        FUN_AFTER(u2, u2.insert(it, 100));
+        FUN_VALUE(u2.node_count());
+        FUN_AFTER(u2, u2.insert(u2.begin(), *u2.begin()));
+        //删除后不足半满的节点会从后一个节点补充或合并
+        FUN_AFTER(u2, u2.erase(u2.begin()));
+        FUN_AFTER(u2, u2.erase(u2.begin(), ++++++u2.begin()));
+        FUN_VALUE(u2.node_count());
+        FUN_VALUE(u2.size());
+        FUN_VALUE(*u2.rbegin());
+        u4 = u2;
+        FUN_VALUE((u4 == u2));
+        FUN_AFTER(u4, u4.swap(u1));
+        FUN_AFTER(u1, u1.clear());
+        FUN_VALUE(u1.empty());
+        //逐个删除，节点数随元素一起减少
+        for (int i = 0; i < 1000; ++i)
+            u1.push_back(i);
+        FUN_VALUE(u1.node_count());
+        for (auto it2 = u1.begin(); it2 != u1.end(); ) {
+            if (*it2 % 3)
+                it2 = u1.erase(it2);
+            else
+                ++it2;
+        }
+        FUN_VALUE(u1.size());
+        FUN_VALUE((u1.node_count() <= u1.size() / 2 + 1));
+        FUN_VALUE(u1.back());
+        std::cout << "[----------------------- end API test "
+                     "---------------------------]\n";
+
+        std::cout << "[--------------------- performance test "
+                     "------------------------]\n";
+        //节点分散在内存中，遍历list每一步都要跳转，unrolled_list每个节点只跳转一次
+        const int n = 2000000;
+        MyStl::list<int> l;
+        MyStl::unrolled_list<int> u;
+        for (int i = 0; i < n; ++i) {
+            l.push_back(i);
+            u.push_back(i);
+        }
+        long long sum1 = 0, sum2 = 0;
+        clock_t start = clock();
+        for (int r = 0; r < 10; ++r)
+            for (auto x = l.begin(); x != l.end(); ++x)
+                sum1 += *x;
+        clock_t end = clock();
+        std::cout << " list traverse " << n << " ints x10 : " << (end - start) * 1000 / CLOCKS_PER_SEC << " ms\n";
+        start = clock();
+        for (int r = 0; r < 10; ++r)
+            for (auto x = u.begin(); x != u.end(); ++x)
+                sum2 += *x;
+        end = clock();
+        std::cout << " unrolled_list traverse " << n << " ints x10 : " << (end - start) * 1000 / CLOCKS_PER_SEC << " ms\n";
+        FUN_VALUE((sum1 == sum2));
+        FUN_VALUE(u.elements_per_node());
+        std::cout << "[------------------ end performance test "
+                     "-----------------------]\n";
+    }
+}
+#endif //MYSTL_TEST_UNROLLED_LIST_H
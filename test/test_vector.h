@@ -3,6 +3,7 @@
 #define MYSTL_TEST_VECTOR_H
 
 #include "iostream"
+#include <cstdio>
 #include "../vector.h"
 #include "vector"
 #include "test_Macros.h"
@@ -68,6 +69,32 @@ namespace MyStl{
         FUN_AFTER(v1, v1.resize(20, 5));
         FUN_AFTER(v1, v1.clear());
         FUN_VALUE(v1.size());
+        //并行初始化
+        MyStl::set_parallel_threshold(1 << 16);
+        MyStl::vector<int> v7(1 << 20, 3);
+        MyStl::vector<int> v8(v7);
+        FUN_VALUE(v7[(1 << 20) - 1]);
+        FUN_VALUE(v8.size());
+        FUN_VALUE(vec_equal(std::vector<int>(1 << 20, 3), v8));
+        FUN_AFTER(v8, v8.reserve(1 << 21); v8.resize(4));
+        MyStl::set_parallel_threshold(0);
+        //快照
+        FILE* file = std::tmpfile();
+        v6.save(fileno(file));
+        std::rewind(file);
+        FUN_AFTER(v1, v1.load(fileno(file)));
+        std::fclose(file);
+        //文件头中的元素个数损坏时拒绝加载，原有内容不变
+        file = std::tmpfile();
+        MyStl::snapshot_write_header(fileno(file), sizeof(int), ~0ULL / 2);
+        std::rewind(file);
+        try {
+            v1.load(fileno(file));
+        } catch (const std::length_error& e) {
+            std::cout << " load threw: " << e.what() << "\n";
+        }
+        std::fclose(file);
+        FUN_VALUE(v1.size());
         std::cout << "[----------------------- end API test "
                      "---------------------------]\n";
     }
@@ -0,0 +1,144 @@
+
+#ifndef MYSTL_THREAD_POOL_H
+#define MYSTL_THREAD_POOL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+namespace MyStl{
+    //库内部使用的小型线程池，供并行初始化等算法使用
+    //线程在第一次使用时创建，进程结束时回收；调用线程本身也会参与任务执行
+    //任务函数不允许抛出异常，异常需要在任务内部捕获后再交给调用者处理
+    class thread_pool{
+    public:
+        //工作线程的上限，初始化类的任务很快就会被内存带宽限制，线程太多并没有意义
+        enum { max_workers = 7 };
+
+        static thread_pool& instance() {
+            static thread_pool pool;
+            return pool;
+        }
+
+        //可以同时执行任务的线程数，包括调用线程
+        size_t concurrency() const { return n_workers + 1; }
+
+        //将任务拆分为n_tasks份，task(i)处理第i份；所有任务执行完毕后才返回
+        void run(size_t n_tasks, const std::function<void(size_t)>& task);
+
+    private:
+        thread_pool();
+        ~thread_pool();
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        //工作线程主循环
+        void worker_loop();
+        //不断领取当前任务的下标并执行，返回执行的份数
+        size_t drain(const std::function<void(size_t)>* task, size_t n_tasks);
+
+    private:
+        std::thread workers[max_workers];
+        size_t n_workers;
+
+        std::mutex run_mutex;                   //同一时间只允许一个run在执行
+        std::mutex mtx;                         //保护下面的任务状态
+        std::condition_variable wake;           //通知工作线程有新任务
+        std::condition_variable done;           //通知调用线程任务已完成
+        const std::function<void(size_t)>* job; //当前任务，为空表示没有任务
+        size_t job_size;
+        size_t finished;                        //已完成的份数
+        size_t active;                          //正在执行当前任务的工作线程数
+        size_t generation;                      //任务编号，用来区分新旧任务
+        bool stop;
+        std::atomic<size_t> next;               //下一个待领取的任务下标
+    };
+
+    inline thread_pool::thread_pool()
+            : n_workers(0), job(nullptr), job_size(0), finished(0),
+              active(0), generation(0), stop(false), next(0) {
+        size_t hw = std::thread::hardware_concurrency();
+        size_t want = hw > 1 ? hw - 1 : 0;
+        if (want > max_workers)
+            want = max_workers;
+        //线程创建失败时就少用几个线程，最差退化为串行执行
+        try {
+            for (; n_workers < want; ++n_workers)
+                workers[n_workers] = std::thread(&thread_pool::worker_loop, this);
+        } catch (...) {
+        }
+    }
+
+    inline thread_pool::~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stop = true;
+        }
+        wake.notify_all();
+        for (size_t i = 0; i < n_workers; ++i)
+            workers[i].join();
+    }
+
+    inline size_t thread_pool::drain(const std::function<void(size_t)>* task, size_t n_tasks) {
+        size_t count = 0;
+        for (size_t i = next.fetch_add(1); i < n_tasks; i = next.fetch_add(1), ++count)
+            (*task)(i);
+        return count;
+    }
+
+    inline void thread_pool::worker_loop() {
+        size_t seen = 0;
+        for (;;) {
+            const std::function<void(size_t)>* task;
+            size_t n_tasks;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                wake.wait(lock, [&] { return stop || (job != nullptr && generation != seen); });
+                if (stop)
+                    return;
+                seen = generation;
+                task = job;
+                n_tasks = job_size;
+                ++active;
+            }
+            size_t count = drain(task, n_tasks);
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                finished += count;
+                --active;
+            }
+            done.notify_all();
+        }
+    }
+
+    inline void thread_pool::run(size_t n_tasks, const std::function<void(size_t)>& task) {
+        if (n_tasks == 0)
+            return;
+        //没有工作线程或者只有一份任务时，直接在当前线程执行
+        if (n_workers == 0 || n_tasks == 1) {
+            for (size_t i = 0; i < n_tasks; ++i)
+                task(i);
+            return;
+        }
+        std::lock_guard<std::mutex> serial(run_mutex);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            job = &task;
+            job_size = n_tasks;
+            finished = 0;
+            next.store(0);
+            ++generation;
+        }
+        wake.notify_all();
+        size_t count = drain(&task, n_tasks);
+        //必须等到所有领取了该任务的工作线程都退出，task才可以被析构
+        std::unique_lock<std::mutex> lock(mtx);
+        finished += count;
+        done.wait(lock, [&] { return finished == job_size && active == 0; });
+        job = nullptr;
+    }
+}
+
+#endif //MYSTL_THREAD_POOL_H
@@ -74,6 +74,16 @@ namespace MyStl{
     template<typename T>
     using remove_reference_t = typename remove_reference<T>::type;
 
+    //编译期整数序列，c++14才有std::index_sequence，这里自己实现一个，用于展开参数包
+    template<size_t... Is>
+    struct index_sequence {};
+    template<size_t N, size_t... Is>
+    struct make_index_sequence_impl : make_index_sequence_impl<N - 1, N - 1, Is...> {};
+    template<size_t... Is>
+    struct make_index_sequence_impl<0, Is...> {using type = index_sequence<Is...>;};
+    template<size_t N>
+    using make_index_sequence = typename make_index_sequence_impl<N>::type;
+
 
 
     //以上是标准库中的做法
@@ -35,12 +35,47 @@ namespace MyStl{
                                                   _false_type){
         ForwardIterator cur = result;
         try {
-            for (; first != last ; ++first, ++cur) {
-                construct(cur, *first);
-                return cur;
-            }
+            for (; first != last ; ++first, ++cur)
+                construct(&*cur, *first);
+            return cur;
         } catch (...) {
             destroy(result, cur);
+            throw;
+        }
+    }
+
+    //与uninitialized_copy相同，只是以右值构造，源区间的元素之后处于被移走的状态
+    template <typename InputIterator, typename ForwardIterator>
+    inline ForwardIterator uninitialized_move(InputIterator first,
+                                              InputIterator last,
+                                              ForwardIterator result) {
+        using value_type =
+                typename MyStl::iterator_traits<ForwardIterator>::value_type;
+        using is_POD = typename type_traits<value_type>::is_POD_type;
+        return _uninitialized_move(first, last, result, is_POD());
+    }
+
+    template <typename InputIterator, typename ForwardIterator>
+    inline ForwardIterator _uninitialized_move(InputIterator first,
+                                               InputIterator last,
+                                               ForwardIterator result,
+                                               _true_type) {
+        return std::copy(first, last, result);
+    }
+
+    template <typename InputIterator, typename ForwardIterator>
+    inline ForwardIterator _uninitialized_move(InputIterator first,
+                                               InputIterator last,
+                                               ForwardIterator result,
+                                               _false_type){
+        ForwardIterator cur = result;
+        try {
+            for (; first != last ; ++first, ++cur)
+                construct(&*cur, MyStl::move(*first));
+            return cur;
+        } catch (...) {
+            destroy(result, cur);
+            throw;
         }
     }
 
@@ -70,8 +105,7 @@ namespace MyStl{
         ForwardIterator cur = first;
         try {
             for (; cur != last; ++cur)
-                construct(cur, value);
-            return cur;
+                construct(&*cur, value);
         } catch (...) {
             destroy(first, cur);
             throw;
@@ -104,7 +138,7 @@ namespace MyStl{
         ForwardIterator cur = first;
         try {
             for (; n != 0; --n, ++cur)
-                construct(cur, value);
+                construct(&*cur, value);
             return cur;
         } catch (...) {
             destroy(first, cur);
@@ -0,0 +1,373 @@
+
+#ifndef MYSTL_UNROLLED_LIST_H
+#define MYSTL_UNROLLED_LIST_H
+
+//展开链表：每个节点用一个小数组保存最多K个元素
+//list的每个元素都带两个指针，元素很小时额外开销比元素本身还大，遍历时每一步都可能缓存未命中
+//unrolled_list在节点内按数组顺序遍历，接近vector的遍历速度，在中间插入也只需要移动一个节点内的元素
+//插入时节点已满则把后一半元素分裂到新节点；删除后节点不足半满时从后一个节点补充元素，能放下时直接合并
+//插入和删除只会使被修改的节点及分裂、合并涉及的相邻节点中的迭代器失效，其他节点中的迭代器保持有效
+//分裂和合并时在节点间移动元素，所以T的移动构造和移动赋值不能抛出异常
+#include <initializer_list>
+#include <type_traits>
+#include "iterator.h"
+#include "pool_allocator.h"
+#include "construct.h"
+#include "move.h"
+
+namespace MyStl{
+    //K为0时让节点正好放进内存池最大的128字节区块，至少放4个元素
+    constexpr size_t unrolled_node_size(size_t k, size_t val_size) {
+        return k != 0 ? k
+                      : ((128 - 3 * sizeof(void*)) / val_size >= 4 ? (128 - 3 * sizeof(void*)) / val_size : 4);
+    }
+
+    template <typename T, size_t K>
+    struct unrolled_node{
+        unrolled_node* next;
+        unrolled_node* prev;
+        //已构造的元素个数，元素依次放在elems()的前count个位置
+        size_t count;
+        typename std::aligned_storage<sizeof(T) * K, alignof(T)>::type storage;
+        T* elems() { return reinterpret_cast<T*>(&storage); }
+    };
+
+    //保存节点指针和节点内的下标，end()指向哨兵节点的下标0
+    template <typename T, size_t K, typename Ref, typename Ptr>
+    struct unrolled_list_iterator{
+        using iterator_category = bidirectional_iterator_tag;
+        using value_type        = T;
+        using difference_type   = ptrdiff_t;
+        using reference         = Ref;
+        using pointer           = Ptr;
+        using self              = unrolled_list_iterator;
+        using node_pointer      = unrolled_node<T, K>*;
+
+        node_pointer node;
+        size_t index;
+
+        unrolled_list_iterator() : node(nullptr), index(0) {}
+        unrolled_list_iterator(node_pointer n, size_t i) : node(n), index(i) {}
+        //iterator可以转换为const_iterator
+        template <typename R, typename P>
+        unrolled_list_iterator(const unrolled_list_iterator<T, K, R, P>& it) : node(it.node), index(it.index) {}
+
+        reference operator*() const { return node->elems()[index]; }
+        pointer operator->() const { return &node->elems()[index]; }
+
+        //节点中的元素走完后进入下一个节点，元素个数为0的只有哨兵
+        self& operator++() {
+            if (++index == node->count) {
+                node = node->next;
+                index = 0;
+            }
+            return *this;
+        }
+        self operator++(int) { self tmp = *this; ++*this; return tmp; }
+        self& operator--() {
+            if (index == 0) {
+                node = node->prev;
+                index = node->count;
+            }
+            --index;
+            return *this;
+        }
+        self operator--(int) { self tmp = *this; --*this; return tmp; }
+
+        bool operator==(const self& rhs) const { return node == rhs.node && index == rhs.index; }
+        bool operator!=(const self& rhs) const { return !(*this == rhs); }
+    };
+
+    template <typename T, size_t K = 0>
+    class unrolled_list{
+    public:
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using iterator = unrolled_list_iterator<T, unrolled_node_size(K, sizeof(T)), T&, T*>;
+        using const_iterator = unrolled_list_iterator<T, unrolled_node_size(K, sizeof(T)), const T&, const T*>;
+        using reverse_iter = reverse_iterator<iterator>;
+        using const_reverse_iter = reverse_iterator<const_iterator>;
+
+    protected:
+        using node_type = unrolled_node<T, unrolled_node_size(K, sizeof(T))>;
+        using node_pointer = node_type*;
+        using node_alloc = pool_alloc<node_type>;
+
+        //环形双向链表的哨兵节点，不保存元素
+        node_pointer head;
+        size_type len;
+
+        static constexpr size_type node_capacity() { return unrolled_node_size(K, sizeof(T)); }
+
+        void empty_initialize() {
+            head = node_alloc::allocate();
+            head->next = head;
+            head->prev = head;
+            head->count = 0;
+            len = 0;
+        }
+        //在pos之后链接一个空节点
+        node_pointer create_node_after(node_pointer pos) {
+            node_pointer p = node_alloc::allocate();
+            p->count = 0;
+            p->prev = pos;
+            p->next = pos->next;
+            pos->next->prev = p;
+            pos->next = p;
+            return p;
+        }
+        //摘下并释放节点，其中的元素必须已经析构或者移走
+        void remove_node(node_pointer p) {
+            p->prev->next = p->next;
+            p->next->prev = p->prev;
+            node_alloc::deallocate(p);
+        }
+        //把满节点的后一半元素移到新节点中，返回新节点
+        node_pointer split(node_pointer p);
+        //把p->next的前k个元素移到p的末尾，取空的节点会被释放
+        void take_from_next(node_pointer p, size_type k);
+        void fill_initialize(size_type n, const value_type& value) {
+            empty_initialize();
+            try {
+                for (; n; --n)
+                    push_back(value);
+            } catch (...) {
+                clear();
+                node_alloc::deallocate(head);
+                throw;
+            }
+        }
+        template <typename InputIterator>
+        void copy_initialize(InputIterator first, InputIterator last) {
+            empty_initialize();
+            try {
+                for (; first != last; ++first)
+                    push_back(*first);
+            } catch (...) {
+                clear();
+                node_alloc::deallocate(head);
+                throw;
+            }
+        }
+
+    public:
+        /*构造与析构*/
+        unrolled_list() { empty_initialize(); }
+        unrolled_list(size_type n, const value_type& value) { fill_initialize(n, value); }
+        unrolled_list(int n, const value_type& value) { fill_initialize(size_type(n), value); }
+        unrolled_list(long n, const value_type& value) { fill_initialize(size_type(n), value); }
+        template <typename InputIterator>
+        unrolled_list(InputIterator first, InputIterator last) { copy_initialize(first, last); }
+        unrolled_list(const unrolled_list& rhs) { copy_initialize(rhs.begin(), rhs.end()); }
+        unrolled_list(std::initializer_list<T> il) { copy_initialize(il.begin(), il.end()); }
+        unrolled_list& operator=(const unrolled_list& rhs) {
+            if (&rhs != this) {
+                unrolled_list temp(rhs);
+                swap(temp);
+            }
+            return *this;
+        }
+        ~unrolled_list() {
+            clear();
+            node_alloc::deallocate(head);
+        }
+
+        //元素访问
+        reference front() { return head->next->elems()[0]; }
+        const_reference front() const { return head->next->elems()[0]; }
+        reference back() { return head->prev->elems()[head->prev->count - 1]; }
+        const_reference back() const { return head->prev->elems()[head->prev->count - 1]; }
+
+        //迭代器
+        iterator begin() { return iterator(head->next, 0); }
+        iterator end() { return iterator(head, 0); }
+        const_iterator begin() const { return const_iterator(head->next, 0); }
+        const_iterator end() const { return const_iterator(head, 0); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+        reverse_iter rbegin() { return reverse_iter(end()); }
+        reverse_iter rend() { return reverse_iter(begin()); }
+
+        //容量
+        size_type size() const { return len; }
+        bool empty() const { return len == 0; }
+        //每个节点最多保存的元素个数
+        static constexpr size_type elements_per_node() { return node_capacity(); }
+        //节点个数，需要遍历节点链表
+        size_type node_count() const {
+            size_type n = 0;
+            for (node_pointer p = head->next; p != head; p = p->next)
+                ++n;
+            return n;
+        }
+
+        //修改器
+        //在pos之前插入，返回指向新元素的迭代器
+        iterator insert(iterator pos, const value_type& value) {
+            //value可能就是链表中的元素，先拷贝一份再移动节点内的元素
+            value_type temp(value);
+            return insert(pos, MyStl::move(temp));
+        }
+        iterator insert(iterator pos, value_type&& value);
+        //删除pos处的元素，返回指向下一个元素的迭代器
+        iterator erase(iterator pos);
+        iterator erase(iterator first, iterator last);
+        void push_back(const value_type& value) { insert(end(), value); }
+        void push_back(value_type&& value) { insert(end(), MyStl::move(value)); }
+        void push_front(const value_type& value) { insert(begin(), value); }
+        void push_front(value_type&& value) { insert(begin(), MyStl::move(value)); }
+        void pop_back() { erase(--end()); }
+        void pop_front() { erase(begin()); }
+        void clear();
+        void swap(unrolled_list& rhs) {
+            std::swap(head, rhs.head);
+            std::swap(len, rhs.len);
+        }
+    };
+
+    template <typename T, size_t K>
+    typename unrolled_list<T, K>::node_pointer unrolled_list<T, K>::split(node_pointer p) {
+        node_pointer q = create_node_after(p);
+        const size_type half = p->count / 2;
+        T* from = p->elems();
+        T* to = q->elems();
+        for (size_type i = half; i < p->count; ++i) {
+            MyStl::construct(to + (i - half), MyStl::move(from[i]));
+            MyStl::destroy(from + i);
+        }
+        q->count = p->count - half;
+        p->count = half;
+        return q;
+    }
+
+    template <typename T, size_t K>
+    void unrolled_list<T, K>::take_from_next(node_pointer p, size_type k) {
+        node_pointer q = p->next;
+        T* to = p->elems();
+        T* from = q->elems();
+        for (size_type i = 0; i < k; ++i)
+            MyStl::construct(to + p->count + i, MyStl::move(from[i]));
+        p->count += k;
+        //剩下的元素移到q的开头
+        for (size_type i = k; i < q->count; ++i)
+            from[i - k] = MyStl::move(from[i]);
+        for (size_type i = (q->count > k ? q->count - k : 0); i < q->count; ++i)
+            MyStl::destroy(from + i);
+        q->count -= k;
+        if (q->count == 0)
+            remove_node(q);
+    }
+
+    template <typename T, size_t K>
+    typename unrolled_list<T, K>::iterator unrolled_list<T, K>::insert(iterator pos, value_type&& value) {
+        node_pointer p = pos.node;
+        size_type i = pos.index;
+        if (i == 0 && p->prev != head && p->prev->count < node_capacity()) {
+            //插在节点开头，前一个节点有空位时追加到它的末尾
+            p = p->prev;
+            i = p->count;
+        } else if (i == 0 && (p == head || p->count == node_capacity())) {
+            //在尾部插入，或者在满节点的开头插入时直接新建节点，顺序地push_back/push_front会把节点填满
+            p = create_node_after(p->prev);
+        } else if (p->count == node_capacity()) {
+            node_pointer q = split(p);
+            if (i > p->count) {
+                i -= p->count;
+                p = q;
+            }
+        }
+        T* e = p->elems();
+        try {
+            if (i == p->count) {
+                MyStl::construct(e + i, MyStl::move(value));
+            } else {
+                MyStl::construct(e + p->count, MyStl::move(e[p->count - 1]));
+                for (size_type j = p->count - 1; j > i; --j)
+                    e[j] = MyStl::move(e[j - 1]);
+                e[i] = MyStl::move(value);
+            }
+        } catch (...) {
+            //新建的节点不能空着留在链表中
+            if (p->count == 0)
+                remove_node(p);
+            throw;
+        }
+        ++p->count;
+        ++len;
+        return iterator(p, i);
+    }
+
+    template <typename T, size_t K>
+    typename unrolled_list<T, K>::iterator unrolled_list<T, K>::erase(iterator pos) {
+        node_pointer p = pos.node;
+        const size_type i = pos.index;
+        T* e = p->elems();
+        for (size_type j = i + 1; j < p->count; ++j)
+            e[j - 1] = MyStl::move(e[j]);
+        MyStl::destroy(e + p->count - 1);
+        --p->count;
+        --len;
+        if (p->count == 0) {
+            node_pointer next = p->next;
+            remove_node(p);
+            return iterator(next, 0);
+        }
+        //不足半满时从后一个节点补充，两个节点能放进一个时直接合并
+        node_pointer next = p->next;
+        if (p->count < node_capacity() / 2 && next != head) {
+            if (p->count + next->count <= node_capacity())
+                take_from_next(p, next->count);
+            else
+                take_from_next(p, node_capacity() / 2 - p->count);
+        }
+        return i < p->count ? iterator(p, i) : iterator(p->next, 0);
+    }
+
+    template <typename T, size_t K>
+    typename unrolled_list<T, K>::iterator unrolled_list<T, K>::erase(iterator first, iterator last) {
+        //删除时节点会合并，last可能失效，所以先数出个数
+        size_type n = 0;
+        for (iterator it = first; it != last; ++it)
+            ++n;
+        for (; n; --n)
+            first = erase(first);
+        return first;
+    }
+
+    template <typename T, size_t K>
+    void unrolled_list<T, K>::clear() {
+        node_pointer p = head->next;
+        while (p != head) {
+            node_pointer next = p->next;
+            MyStl::destroy(p->elems(), p->elems() + p->count);
+            node_alloc::deallocate(p);
+            p = next;
+        }
+        head->next = head;
+        head->prev = head;
+        len = 0;
+    }
+
+    template <typename T, size_t K>
+    bool operator==(const unrolled_list<T, K>& lhs, const unrolled_list<T, K>& rhs) {
+        if (lhs.size() != rhs.size())
+            return false;
+        auto it1 = lhs.begin();
+        for (auto it2 = rhs.begin(); it2 != rhs.end(); ++it1, ++it2)
+            if (!(*it1 == *it2))
+                return false;
+        return true;
+    }
+
+    template <typename T, size_t K>
+    bool operator!=(const unrolled_list<T, K>& lhs, const unrolled_list<T, K>& rhs) {
+        return !(lhs == rhs);
+    }
+}
+
+#endif //MYSTL_UNROLLED_LIST_H
@@ -5,6 +5,9 @@
 #include "pool_allocator.h"
 #include "iterator.h"
 #include "uninitialized.h"
+#include "parallel_uninitialized.h"
+#include "snapshot.h"
+#include <type_traits>
 #include "initializer_list"
 namespace MyStl{
     template <typename T, typename Allocator = pool_alloc<T>>
@@ -58,7 +61,7 @@ namespace MyStl{
         vector<T, Allocator>& operator=(std::initializer_list<T> rhs);
 
         ~vector(){
-            destroy(start, finish);
+            MyStl::destroy(start, finish);
             deallocate();
         }
 
@@ -106,7 +109,7 @@ namespace MyStl{
         iterator insert(iterator pos, const value_type& value = T()){
             auto offset = pos - cbegin();
             if (finish != end_of_storage && pos == finish)
-                construct(finish++, value);
+                MyStl::construct(finish++, value);
             else
                 insert_aux(pos, value);
             return start + offset;
@@ -116,8 +119,41 @@ namespace MyStl{
         iterator erase( iterator first, iterator last );
         void resize( size_type count, const value_type& value = T());
         void clear(){ erase(start,finish);}
+
+        //快照，只支持可平凡拷贝的元素：写入文件头和原始内存，读取时直接读入新分配的内存
+        void save(int fd) const;
+        void load(int fd);
     };
 
+    template<typename T, typename Allocator>
+    void vector<T, Allocator>::save(int fd) const {
+        static_assert(std::is_trivially_copyable<T>::value, "vector::save requires trivially copyable T");
+        snapshot_write_header(fd, sizeof(T), size());
+        snapshot_write(fd, start, size() * sizeof(T));
+    }
+
+    template<typename T, typename Allocator>
+    void vector<T, Allocator>::load(int fd) {
+        static_assert(std::is_trivially_copyable<T>::value, "vector::load requires trivially copyable T");
+        size_type n = snapshot_read_header(fd, sizeof(T));
+        //文件头损坏时元素个数可能非常大，n * sizeof(T)会溢出
+        if (n > max_size())
+            throw std::length_error("vector::load: element count too large");
+        iterator new_start = Allocator::allocate(n);
+        //读取失败时原有内容保持不变
+        try {
+            snapshot_read(fd, new_start, n * sizeof(T));
+        } catch (...) {
+            Allocator::deallocate(new_start, n);
+            throw;
+        }
+        MyStl::destroy(start, finish);
+        deallocate();
+        start = new_start;
+        finish = start + n;
+        end_of_storage = finish;
+    }
+
 
     template<typename T, typename Allocator>
     void vector<T, Allocator>::resize(vector::size_type count, const value_type &value) {
@@ -130,7 +166,7 @@ namespace MyStl{
     template<typename T, typename Allocator>
     typename vector<T, Allocator>::iterator vector<T, Allocator>::erase(iterator first, iterator last) {
         iterator new_finish = std::copy(last, finish, first);
-        destroy(new_finish, finish);
+        MyStl::destroy(new_finish, finish);
         finish = new_finish;
         return first;
     }
@@ -141,7 +177,7 @@ namespace MyStl{
             std::copy(pos + 1, finish, pos);
         }
         --finish;
-        destroy(finish);
+        MyStl::destroy(finish);
         return pos;
     }
 
@@ -155,16 +191,16 @@ namespace MyStl{
             if (elems_after > n){
                 //如果插入的数量比较少, 那么先后移再插入
                 //把末尾的n个元素,初始化copy到end()起始
-                uninitialized_copy(finish - n, finish, finish);
+                MyStl::uninitialized_copy(finish - n, finish, finish);
                 //以finish为终点,使用copy_backward进行copy
                 std::copy_backward(pos, finish - n, finish);
                 std::fill(pos, pos + n, value);
             } else{
                 //插入的数量较多,则没有必要进行copy_backward操作
                 //先把末尾进行填充
-                uninitialized_fill_n(finish, n - elems_after, value);
+                MyStl::uninitialized_fill_n(finish, n - elems_after, value);
                 //再把pos之后的原数据,转移到应该在的位置
-                uninitialized_copy(pos, finish, pos + n);
+                MyStl::uninitialized_copy(pos, finish, pos + n);
                 //最后插入
                 std::fill(pos, pos + n, value);
             }
@@ -179,9 +215,9 @@ namespace MyStl{
             iterator new_finish = new_start;
             //程序员控制释放内存
             try {
-                new_finish = uninitialized_copy(start, pos, new_start);
-                new_finish = uninitialized_fill_n(new_finish, n, value);
-                new_finish = uninitialized_copy(pos, finish, new_finish);
+                new_finish = MyStl::uninitialized_copy(start, pos, new_start);
+                new_finish = MyStl::uninitialized_fill_n(new_finish, n, value);
+                new_finish = MyStl::uninitialized_copy(pos, finish, new_finish);
             } catch (...) {
                 //先析构再释放内存空间
                 //destroy(new_start, new_finish);
@@ -189,7 +225,7 @@ namespace MyStl{
                 throw;
             }
             //无异常则析构并释放原内存
-            destroy(start, finish);
+            MyStl::destroy(start, finish);
             deallocate();
             start = new_start;
             finish = new_finish;
@@ -208,13 +244,13 @@ namespace MyStl{
     template<typename T, typename Allocator>
     void vector<T, Allocator>::pop_back() {
         --finish;
-        destroy(finish);
+        MyStl::destroy(finish);
     }
 
     template<typename T, typename Allocator>
     void vector<T, Allocator>::push_back(const T &value) {
         if (finish != end_of_storage)
-            construct(finish, value);
+            MyStl::construct(finish++, value);
         else
             insert_aux(end(), value);
     }
@@ -225,13 +261,14 @@ namespace MyStl{
             iterator new_start = Allocator::allocate(new_cap);
             iterator new_finish = new_start;
             try {
-                new_finish = uninitialized_copy(start, finish, new_start);
+                new_finish = parallel_uninitialized_copy(start, finish, new_start);
             } catch(...) {
                 //uninitialized_copy负责了析构
                 //destroy(new_start, new_finish)
                 Allocator::deallocate(new_start, new_cap);
+                throw;
             }
-            destroy(start, finish);
+            MyStl::destroy(start, finish);
             deallocate();
             start = new_start;
             finish = new_finish;
@@ -247,20 +284,20 @@ namespace MyStl{
             //如果要拷贝的容积大于现有的容积,则要重新分配内存
             if (new_size > capacity()){
                 iterator new_start = Allocator::allocate(new_size);
-                end_of_storage = uninitialized_copy(vec.begin(), vec.end(), new_start);
-                destroy(start,finish);
+                end_of_storage = MyStl::uninitialized_copy(vec.begin(), vec.end(), new_start);
+                MyStl::destroy(start,finish);
                 deallocate();
                 start = new_start;
             }
             //如果比现在的size还行,那么拷贝后还需要清楚原来剩余的内容
             else if (new_size < size()){
                 iterator it = std::copy(vec.begin(), vec.end(), start);
-                destroy(it, finish);
+                MyStl::destroy(it, finish);
             }
             //size() < new_size < capacity()
             else {
                 std::copy(vec.begin(), vec.begin() + size(), start);
-                uninitialized_copy(vec.begin() + size(), vec.end(), finish);
+                MyStl::uninitialized_copy(vec.begin() + size(), vec.end(), finish);
             }
             finish = start + new_size;
         }
@@ -281,12 +318,14 @@ namespace MyStl{
         start = Allocator::allocate(n);
         //维护内存分配与释放
         //uninitialized_fill_n处理的了析构的异常情况，在这里我们需要处理内存分配的情况
+        //元素很多时可以交给线程池并行构造，异常处理与串行版本一致
         try {
-            uninitialized_fill_n(start, n, value);
+            parallel_uninitialized_fill_n(start, n, value);
             finish = start + n;
             end_of_storage = finish;
         } catch (...) {
             Allocator::deallocate(start, n);
+            throw;
         }
     }
 
@@ -296,11 +335,12 @@ namespace MyStl{
         size_type n = last - first;
         start = Allocator::allocate(n);
         try {
-            uninitialized_copy(first, last, start);
+            parallel_uninitialized_copy(first, last, start);
             finish = start + n;
             end_of_storage = finish;
         } catch (...) {
             Allocator::deallocate(start, n);
+            throw;
         }
     }
 
@@ -309,7 +349,7 @@ namespace MyStl{
         //还有容量
         //先将最后一个元素在end的位置构造
         if (finish != end_of_storage){
-            construct(finish, *(finish-1));
+            MyStl::construct(finish, *(finish-1));
             ++finish;
             //使用stl算法，将position起的元素逐后copy一位
             std::copy_backward(position, finish-2, finish - 1);
@@ -324,9 +364,9 @@ namespace MyStl{
             iterator new_finish = new_start;
             //程序员控制释放内存
             try {
-                new_finish = uninitialized_copy(start, position, new_start);
-                construct(new_finish++, value);
-                new_finish = uninitialized_copy(position, finish, new_finish);
+                new_finish = MyStl::uninitialized_copy(start, position, new_start);
+                MyStl::construct(new_finish++, value);
+                new_finish = MyStl::uninitialized_copy(position, finish, new_finish);
             } catch (...) {
             //先析构再释放内存空间
                 //destroy(new_start, new_finish);
@@ -334,7 +374,7 @@ namespace MyStl{
                 throw;
             }
             //无异常则析构并释放原内存
-            destroy(start, finish);
+            MyStl::destroy(start, finish);
             deallocate();
             start = new_start;
             finish = new_finish;